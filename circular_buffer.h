@@ -1,55 +1,812 @@
 #pragma once
 
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/sort_array.h"
+#include "core/templates/span.h"
 #include "core/variant/typed_array.h"
 #include "core/variant/variant.h"
 
-class CircularBuffer : public RefCounted {
-	GDCLASS(CircularBuffer, RefCounted)
+/**
+ * Ring storage shared by every circular buffer flavour.
+ *
+ * Elements live in a single contiguous LocalVector, so typed buffers keep raw
+ * values (float, Vector2...) instead of boxed Variants.
+ */
+template <typename T>
+class CircularStorage {
+private:
+	LocalVector<T> data;
+	int _head = 0;
+	int _size = 0;
+	int _mask = -1; // capacity - 1 in power of two mode, -1 otherwise
+	int _requested_capacity = 0; // as passed to resize, restored when leaving power of two mode
+
+	// Wraps a position into [0, capacity), p_pos can only be negative in power of two mode.
+	_FORCE_INLINE_ int _wrap(int p_pos) const {
+		return _mask >= 0 ? (p_pos & _mask) : (p_pos % (int)data.size());
+	}
+
+	// Maps a logical index, 0 being the oldest element, to its slot in data.
+	_FORCE_INLINE_ int _slot(int p_index) const {
+		return _wrap((int)data.size() + _head - _size + p_index);
+	}
+
+	// Resolves the slice bounds, returns the number of elements to copy or -1 on error.
+	int _slice_bounds(int p_begin, int p_end, int p_step, int &r_begin) const {
+		ERR_FAIL_COND_V_MSG(p_step == 0, -1, "Slice step cannot be zero.");
+
+		const int s = _size;
+
+		if (s == 0 || (p_begin < -s && p_step < 0) || (p_begin >= s && p_step > 0)) {
+			return -1;
+		}
+
+		int begin = CLAMP(p_begin, -s, s - 1);
+		if (begin < 0) {
+			begin += s;
+		}
+		int end = CLAMP(p_end, -s - 1, s);
+		if (end < 0) {
+			end += s;
+		}
+
+		ERR_FAIL_COND_V_MSG(p_step > 0 && begin > end, -1, "Slice step is positive, but bounds are decreasing.");
+		ERR_FAIL_COND_V_MSG(p_step < 0 && begin < end, -1, "Slice step is negative, but bounds are increasing.");
+
+		r_begin = begin;
+		return (end - begin) / p_step + (((end - begin) % p_step != 0) ? 1 : 0);
+	}
+
+	static _FORCE_INLINE_ void _copy(T *r_dst, const T *p_src, int p_count) {
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			memcpy(r_dst, p_src, sizeof(T) * p_count);
+		} else {
+			for (int i = 0; i < p_count; i++) {
+				r_dst[i] = p_src[i];
+			}
+		}
+	}
+
+	// Calls p_write(dest_index, value) for every sliced element, without a modulo per element.
+	template <typename W>
+	void _slice_walk(int p_begin, int p_count, int p_step, W p_write) const {
+		if (p_step == 1) {
+			Span<T> first;
+			Span<T> second;
+			get_spans(p_begin, p_count, first, second);
+
+			const int first_count = first.size();
+			for (int i = 0; i < first_count; i++) {
+				p_write(i, first[i]);
+			}
+			for (int i = 0; i < (int)second.size(); i++) {
+				p_write(first_count + i, second[i]);
+			}
+			return;
+		}
+
+		// Strided copy, the stride is reduced so a single wrap per step is enough.
+		const int c = data.size();
+		const int stride = p_step % c;
+		int slot = _slot(p_begin);
+		for (int i = 0; i < p_count; i++) {
+			p_write(i, data[slot]);
+			slot += stride;
+			if (slot >= c) {
+				slot -= c;
+			} else if (slot < 0) {
+				slot += c;
+			}
+		}
+	}
+
+public:
+	_FORCE_INLINE_ bool is_empty() const { return _size == 0; }
+	_FORCE_INLINE_ int capacity() const { return data.size(); }
+	_FORCE_INLINE_ int size() const { return _size; }
+	_FORCE_INLINE_ int head() const { return _head; }
+
+	// Maps a logical index, 0 being the oldest element, to its slot, for data kept alongside the ring.
+	_FORCE_INLINE_ int get_slot(int p_index) const { return _slot(p_index); }
+
+	/**
+	 * Returns the logical range [p_begin, p_begin + p_count) as two contiguous views.
+	 *
+	 * A ring never spans more than two runs of memory, the second one is empty
+	 * when the range does not wrap. The views are invalidated by any write.
+	 */
+	void get_spans(int p_begin, int p_count, Span<T> &r_first, Span<T> &r_second) const {
+		r_first = Span<T>();
+		r_second = Span<T>();
+		ERR_FAIL_COND(p_begin < 0 || p_count < 0 || p_begin + p_count > _size);
+		if (p_count == 0) {
+			return;
+		}
+
+		const int slot = _slot(p_begin);
+		const int first_count = MIN(p_count, (int)data.size() - slot);
+		r_first = Span<T>(data.ptr() + slot, first_count);
+		if (first_count < p_count) {
+			r_second = Span<T>(data.ptr(), p_count - first_count);
+		}
+	}
+
+	// Returns the whole content, oldest first, as two contiguous views.
+	void get_spans(Span<T> &r_first, Span<T> &r_second) const {
+		get_spans(0, _size, r_first, r_second);
+	}
+
+	void clear() {
+		// Do not actually clear anything, just reset head and size
+		_head = 0;
+		_size = 0;
+	}
+
+	void resize(int p_capacity) {
+		ERR_FAIL_COND(p_capacity < 0);
+
+		_requested_capacity = p_capacity;
+		if (is_power_of_two()) {
+			p_capacity = p_capacity > 0 ? (int)next_power_of_2((uint32_t)p_capacity) : 0;
+			_mask = MAX(p_capacity - 1, 0);
+		}
+
+		_head = 0;
+		_size = 0;
+		data.resize(p_capacity);
+		for (int i = 0; i < p_capacity; i++) {
+			data[i] = T();
+		}
+	}
+
+	/**
+	 * Opt-in mode where the capacity is rounded up to a power of two,
+	 * so indexing becomes a mask instead of an integer division.
+	 *
+	 * Changing the mode resizes the buffer, discarding its content, leaving it
+	 * restores the capacity last passed to resize().
+	 */
+	void set_power_of_two(bool p_enabled) {
+		if (p_enabled == is_power_of_two()) {
+			return;
+		}
+		_mask = p_enabled ? 0 : -1;
+		resize(_requested_capacity);
+	}
+
+	_FORCE_INLINE_ bool is_power_of_two() const { return _mask >= 0; }
+
+	void fill(const T &p_value) {
+		const int s = data.size();
+		if (s == 0) {
+			return;
+		}
+
+		_head = 0;
+		_size = s;
+		for (int i = 0; i < s; i++) {
+			data[i] = p_value;
+		}
+	}
+
+	void advance(int p_steps) {
+		const int s = data.size();
+		if (s == 0) {
+			return;
+		}
+
+		// Allow arbitrary large positive or negative values
+		_head = _wrap(_head + (p_steps % s) + s);
+	}
+
+	void seek(const int p_pos) {
+		ERR_FAIL_COND(p_pos < 0 || p_pos > (int)data.size());
+		_head = p_pos;
+	}
+
+	void set_size(const int p_size) {
+		ERR_FAIL_COND(p_size < 0 || p_size > (int)data.size());
+		_size = p_size;
+	}
+
+	void append(const T &p_value) {
+		const int s = data.size();
+		if (s == 0) {
+			return;
+		}
+
+		data[_head] = p_value;
+
+		_head = _wrap(_head + 1);
+		if (_size < s) {
+			_size++;
+		}
+	}
+
+	void append_array(const T *p_src, int p_count) {
+		const int c = data.size();
+		if (c == 0 || p_count <= 0) {
+			return;
+		}
+
+		// Only the last capacity elements survive, skip the ones that would be overwritten anyway
+		const int skip = MAX(0, p_count - c);
+		const int count = p_count - skip;
+		_head = _wrap(_head + skip);
+
+		const int first_count = MIN(count, c - _head);
+		_copy(&data[_head], p_src + skip, first_count);
+		_copy(data.ptr(), p_src + skip + first_count, count - first_count);
+
+		_head = _wrap(_head + count);
+		_size = MIN(_size + p_count, c);
+	}
+
+	void append_array(const Vector<T> &p_array) {
+		append_array(p_array.ptr(), p_array.size());
+	}
+
+	void append_array(const Array &p_array) {
+		const int c = data.size();
+		const int p_count = p_array.size();
+		if (c == 0 || p_count == 0) {
+			return;
+		}
+
+		const int skip = MAX(0, p_count - c);
+		const int count = p_count - skip;
+		_head = _wrap(_head + skip);
+
+		const int first_count = MIN(count, c - _head);
+		for (int i = 0; i < first_count; i++) {
+			data[_head + i] = p_array[skip + i];
+		}
+		for (int i = first_count; i < count; i++) {
+			data[i - first_count] = p_array[skip + i];
+		}
+
+		_head = _wrap(_head + count);
+		_size = MIN(_size + p_count, c);
+	}
+
+	void push_front(const T &p_value) {
+		const int s = data.size();
+		if (s == 0) {
+			return;
+		}
+
+		// Move head backwards and insert
+		_head = _wrap(_head - 1 + s);
+		data[_head] = p_value;
+
+		if (_size < s) {
+			_size++;
+		}
+	}
+
+	void insert(int p_pos, const T &p_value) {
+		const int c = data.size();
+		if (c == 0) {
+			return;
+		}
+
+		ERR_FAIL_COND_MSG(p_pos < 0 || p_pos > _size, "Insert position out of bounds.");
+
+		if (_size >= c) {
+			// Buffer is full, can't insert
+			return;
+		}
+
+		// Shift elements to make space
+		for (int i = _size; i > p_pos; i--) {
+			data[_slot(i)] = data[_slot(i - 1)];
+		}
+
+		// Insert the new value
+		data[_slot(p_pos)] = p_value;
+		_size++;
+	}
+
+	T pop_back() {
+		ERR_FAIL_COND_V_MSG(_size == 0, T(), "Can't pop from empty buffer.");
+
+		const int s = data.size();
+		// Get the last element (most recently added)
+		const int index = _wrap(_head - 1 + s);
+		T result = data[index];
+
+		// Move head backwards
+		_head = index;
+		_size--;
+
+		return result;
+	}
+
+	T pop_front() {
+		ERR_FAIL_COND_V_MSG(_size == 0, T(), "Can't pop from empty buffer.");
+
+		// Get the first element (oldest)
+		T result = data[_slot(0)];
+
+		// Just decrease size, don't move head
+		_size--;
+
+		return result;
+	}
+
+	T pop_at(int p_pos) {
+		ERR_FAIL_COND_V_MSG(_size == 0, T(), "Can't pop from empty buffer.");
+		ERR_FAIL_COND_V_MSG(p_pos < 0 || p_pos >= _size, T(), "Index out of bounds.");
+
+		T result = data[_slot(p_pos)];
+
+		// Shift elements to fill the gap
+		for (int i = p_pos; i < _size - 1; i++) {
+			data[_slot(i)] = data[_slot(i + 1)];
+		}
+
+		_size--;
+		return result;
+	}
+
+	T front() const {
+		ERR_FAIL_COND_V_MSG(_size == 0, T(), "Can't take value from empty buffer.");
+
+		const int s = data.size();
+		return data[_wrap(_head - 1 + s)];
+	}
+
+	T back() const {
+		ERR_FAIL_COND_V_MSG(_size == 0, T(), "Can't take value from empty buffer.");
+
+		return data[_slot(0)];
+	}
+
+	T at(int p_index) const {
+		// Index must be within bounds, from -size to size-1
+		ERR_FAIL_COND_V_MSG(p_index < -_size || p_index >= _size, T(), "Index " + itos(p_index) + " is out of bounds (size: " + itos(_size) + ").");
+
+		if (p_index < 0) {
+			p_index += _size;
+		}
+
+		return data[_slot(p_index)];
+	}
+
+	T array_get(int p_index) const {
+		if (_size == 0 || data.is_empty() || p_index < 0 || p_index >= _size) {
+			return T();
+		}
+
+		return data[_slot(p_index)];
+	}
+
+	void array_set(int p_index, const T &p_value) {
+		if (_size == 0 || data.is_empty() || p_index < 0 || p_index >= _size) {
+			return;
+		}
+
+		data[_slot(p_index)] = p_value;
+	}
+
+	void slice(Vector<T> &r_result, int p_begin, int p_end, int p_step) const {
+		int begin = 0;
+		const int result_size = _slice_bounds(p_begin, p_end, p_step, begin);
+		if (result_size <= 0) {
+			return;
+		}
+
+		r_result.resize(result_size);
+		T *w = r_result.ptrw();
+
+		if (p_step == 1) {
+			// One or two block copies
+			Span<T> first;
+			Span<T> second;
+			get_spans(begin, result_size, first, second);
+			_copy(w, first.ptr(), first.size());
+			_copy(w + first.size(), second.ptr(), second.size());
+			return;
+		}
+
+		_slice_walk(begin, result_size, p_step, [w](int p_idx, const T &p_value) {
+			w[p_idx] = p_value;
+		});
+	}
+
+	void slice(Array &r_result, int p_begin, int p_end, int p_step) const {
+		int begin = 0;
+		const int result_size = _slice_bounds(p_begin, p_end, p_step, begin);
+		if (result_size <= 0) {
+			return;
+		}
+
+		r_result.resize(result_size);
+		_slice_walk(begin, result_size, p_step, [&r_result](int p_idx, const T &p_value) {
+			r_result.set(p_idx, p_value);
+		});
+	}
+};
+
+/**
+ * Circular storage for numeric values that keeps windowed statistics up to date.
+ *
+ * Appending and popping the oldest element update the running sum and the
+ * monotonic min/max queues in O(1) amortized. Any other mutation marks the
+ * statistics dirty, they are rebuilt from the spans on the next query.
+ *
+ * A floating point sum drifts under repeated add/subtract, it is summed again
+ * from the storage every time the head wraps, still O(1) amortized.
+ */
+template <typename T>
+class CircularStatsStorage : public CircularStorage<T> {
+	typedef CircularStorage<T> Base;
+
+public:
+	typedef std::conditional_t<std::is_integral_v<T>, int64_t, double> Sum;
 
 private:
-	LocalVector<Variant> data_array;
-	int _head;
-	int _size;
+	struct Entry {
+		uint64_t seq = 0;
+		T value = T();
+	};
+
+	// Queue of candidate extremes, never holds more entries than the window.
+	template <typename Compare>
+	struct MonotonicQueue {
+		LocalVector<Entry> ring;
+		uint32_t first = 0;
+		uint32_t count = 0;
+
+		_FORCE_INLINE_ uint32_t _at(uint32_t p_offset) const {
+			const uint32_t i = first + p_offset;
+			return i >= ring.size() ? i - ring.size() : i;
+		}
+
+		void reset(uint32_t p_capacity) {
+			ring.resize(p_capacity);
+			first = 0;
+			count = 0;
+		}
+
+		void push(uint64_t p_seq, const T &p_value) {
+			// Entries that are not better than the new value can never be the extreme again
+			while (count > 0 && !Compare()(ring[_at(count - 1)].value, p_value)) {
+				count--;
+			}
+			Entry &e = ring[_at(count)];
+			e.seq = p_seq;
+			e.value = p_value;
+			count++;
+		}
+
+		void evict(uint64_t p_seq) {
+			if (count > 0 && ring[first].seq == p_seq) {
+				first = _at(1);
+				count--;
+			}
+		}
+
+		_FORCE_INLINE_ const T &front() const { return ring[first].value; }
+	};
+
+	struct Less {
+		_FORCE_INLINE_ bool operator()(const T &p_a, const T &p_b) const { return p_a < p_b; }
+	};
+
+	struct Greater {
+		_FORCE_INLINE_ bool operator()(const T &p_a, const T &p_b) const { return p_a > p_b; }
+	};
+
+	mutable bool _dirty = true;
+	mutable Sum _sum = 0;
+	mutable uint64_t _seq = 0; // sequence number of the next appended element
+	mutable MonotonicQueue<Less> _min;
+	mutable MonotonicQueue<Greater> _max;
+	mutable LocalVector<T> _scratch;
 
-protected:
-	static void _bind_methods();
+	void _accumulate(const Span<T> &p_span) const {
+		const T *r = p_span.ptr();
+		const int count = p_span.size();
+
+		Sum sum = 0;
+		for (int i = 0; i < count; i++) {
+			sum += r[i];
+		}
+		_sum += sum;
+
+		for (int i = 0; i < count; i++) {
+			_min.push(_seq, r[i]);
+			_max.push(_seq, r[i]);
+			_seq++;
+		}
+	}
+
+	void _resum() const {
+		Span<T> first;
+		Span<T> second;
+		Base::get_spans(first, second);
+
+		Sum sum = 0;
+		for (uint32_t i = 0; i < first.size(); i++) {
+			sum += first[i];
+		}
+		for (uint32_t i = 0; i < second.size(); i++) {
+			sum += second[i];
+		}
+		_sum = sum;
+	}
+
+	void _rebuild() const {
+		_sum = 0;
+		_seq = 0;
+		_min.reset(Base::capacity());
+		_max.reset(Base::capacity());
+
+		Span<T> first;
+		Span<T> second;
+		Base::get_spans(first, second);
+		_accumulate(first);
+		_accumulate(second);
+
+		_dirty = false;
+	}
+
+	void _push(const T &p_value) {
+		_sum += p_value;
+		_min.push(_seq, p_value);
+		_max.push(_seq, p_value);
+		_seq++;
+	}
+
+	void _evict_oldest() {
+		const uint64_t seq = _seq - Base::size();
+		_sum -= Base::array_get(0);
+		_min.evict(seq);
+		_max.evict(seq);
+	}
 
 public:
-	bool is_empty() const;
-	int capacity() const;
-	int size() const;
-	int head() const;
+	void clear() {
+		Base::clear();
+		_dirty = true;
+	}
+
+	void resize(int p_capacity) {
+		Base::resize(p_capacity);
+		_dirty = true;
+	}
+
+	void set_power_of_two(bool p_enabled) {
+		Base::set_power_of_two(p_enabled);
+		_dirty = true;
+	}
+
+	void fill(const T &p_value) {
+		Base::fill(p_value);
+		_dirty = true;
+	}
+
+	void advance(int p_steps) {
+		Base::advance(p_steps);
+		_dirty = true;
+	}
+
+	void seek(const int p_pos) {
+		Base::seek(p_pos);
+		_dirty = true;
+	}
+
+	void set_size(const int p_size) {
+		Base::set_size(p_size);
+		_dirty = true;
+	}
 
-	void clear();
-	void resize(const int p_capacity);
-	void fill(const Variant &p_value);
+	void append(const T &p_value) {
+		if (Base::capacity() == 0) {
+			return;
+		}
 
-	void advance(const int p_steps = 1);
-	void seek(const int p_pos);
-	void set_size(const int p_size);
+		if (!_dirty) {
+			if (Base::size() == Base::capacity()) {
+				_evict_oldest();
+			}
+			_push(p_value);
+		}
+		Base::append(p_value);
 
-	void append(const Variant &p_value);
-	void append_array(const Array &p_array);
-	void insert(int p_pos, const Variant &p_value);
+		if constexpr (std::is_floating_point_v<T>) {
+			if (!_dirty && Base::head() == 0) {
+				_resum();
+			}
+		}
+	}
 
-	void push_front(const Variant &p_value);
-	void push_back(const Variant &p_value);
+	void append_array(const T *p_src, int p_count) {
+		Base::append_array(p_src, p_count);
+		_dirty = true;
+	}
 
-	Variant pop_back();
-	Variant pop_front();
-	Variant pop_at(int p_pos);
+	void append_array(const Vector<T> &p_array) {
+		Base::append_array(p_array);
+		_dirty = true;
+	}
 
-	Variant front() const;
-	Variant back() const;
+	void append_array(const Array &p_array) {
+		Base::append_array(p_array);
+		_dirty = true;
+	}
 
-	Variant at(const int p_index) const;
-	Variant array_get(const int p_index) const;
-	void array_set(const int p_index, const Variant &p_value);
+	void push_front(const T &p_value) {
+		Base::push_front(p_value);
+		_dirty = true;
+	}
 
-	Array duplicate() const;
+	void insert(int p_pos, const T &p_value) {
+		Base::insert(p_pos, p_value);
+		_dirty = true;
+	}
 
-	Array slice(int p_begin, int p_end = INT_MAX, int p_step = 1) const;
+	T pop_back() {
+		_dirty = true;
+		return Base::pop_back();
+	}
 
-	CircularBuffer() = default;
+	T pop_front() {
+		if (!_dirty && Base::size() > 0) {
+			_evict_oldest();
+		}
+		return Base::pop_front();
+	}
+
+	T pop_at(int p_pos) {
+		_dirty = true;
+		return Base::pop_at(p_pos);
+	}
+
+	void array_set(int p_index, const T &p_value) {
+		Base::array_set(p_index, p_value);
+		_dirty = true;
+	}
+
+	Sum sum() const {
+		if (_dirty) {
+			_rebuild();
+		}
+		return _sum;
+	}
+
+	double mean() const {
+		if (Base::is_empty()) {
+			return 0.0;
+		}
+		return double(sum()) / double(Base::size());
+	}
+
+	T min() const {
+		ERR_FAIL_COND_V_MSG(Base::is_empty(), T(), "Can't take value from empty buffer.");
+		if (_dirty) {
+			_rebuild();
+		}
+		return _min.front();
+	}
+
+	T max() const {
+		ERR_FAIL_COND_V_MSG(Base::is_empty(), T(), "Can't take value from empty buffer.");
+		if (_dirty) {
+			_rebuild();
+		}
+		return _max.front();
+	}
+
+	// Nearest-rank percentile, p_ratio goes from 0 (min) to 1 (max). Runs in O(n) on a reused scratch buffer.
+	T percentile(double p_ratio) const {
+		ERR_FAIL_COND_V_MSG(Base::is_empty(), T(), "Can't take value from empty buffer.");
+		ERR_FAIL_COND_V_MSG(p_ratio < 0.0 || p_ratio > 1.0, T(), "Percentile ratio must be between 0 and 1.");
+
+		const int count = Base::size();
+		_scratch.resize(count);
+
+		Span<T> first;
+		Span<T> second;
+		Base::get_spans(first, second);
+		memcpy(_scratch.ptr(), first.ptr(), sizeof(T) * first.size());
+		memcpy(_scratch.ptr() + first.size(), second.ptr(), sizeof(T) * second.size());
+
+		const int nth = (int)Math::round(p_ratio * (count - 1));
+		SortArray<T> sorter;
+		sorter.nth_element(0, count, nth, _scratch.ptr());
+		return _scratch[nth];
+	}
 };
+
+// Shared body of every scriptable circular buffer, bind it with CIRCULAR_BUFFER_BIND_METHODS.
+#define CIRCULAR_BUFFER_BODY(m_class, m_storage, m_type, m_array)                                     \
+	GDCLASS(m_class, RefCounted)                                                                      \
+                                                                                                      \
+private:                                                                                              \
+	m_storage storage;                                                                                \
+                                                                                                      \
+protected:                                                                                            \
+	static void _bind_methods();                                                                      \
+                                                                                                      \
+public:                                                                                               \
+	m_storage &get_storage() { return storage; }                                                      \
+	const m_storage &get_storage() const { return storage; }                                          \
+                                                                                                      \
+	bool is_empty() const { return storage.is_empty(); }                                              \
+	int capacity() const { return storage.capacity(); }                                               \
+	int size() const { return storage.size(); }                                                       \
+	int head() const { return storage.head(); }                                                       \
+                                                                                                      \
+	void clear() { storage.clear(); }                                                                 \
+	void resize(const int p_capacity) { storage.resize(p_capacity); }                                 \
+	void set_power_of_two(bool p_enabled) { storage.set_power_of_two(p_enabled); }                    \
+	bool is_power_of_two() const { return storage.is_power_of_two(); }                                \
+	void fill(const m_type &p_value) { storage.fill(p_value); }                                       \
+                                                                                                      \
+	void advance(const int p_steps = 1) { storage.advance(p_steps); }                                 \
+	void seek(const int p_pos) { storage.seek(p_pos); }                                               \
+	void set_size(const int p_size) { storage.set_size(p_size); }                                     \
+                                                                                                      \
+	void append(const m_type &p_value) { storage.append(p_value); }                                   \
+	void append_array(const m_array &p_array) { storage.append_array(p_array); }                      \
+	void insert(int p_pos, const m_type &p_value) { storage.insert(p_pos, p_value); }                 \
+                                                                                                      \
+	void push_front(const m_type &p_value) { storage.push_front(p_value); }                           \
+	void push_back(const m_type &p_value) { storage.append(p_value); }                                \
+                                                                                                      \
+	m_type pop_back() { return storage.pop_back(); }                                                  \
+	m_type pop_front() { return storage.pop_front(); }                                                \
+	m_type pop_at(int p_pos) { return storage.pop_at(p_pos); }                                        \
+                                                                                                      \
+	m_type front() const { return storage.front(); }                                                  \
+	m_type back() const { return storage.back(); }                                                    \
+                                                                                                      \
+	m_type at(const int p_index) const { return storage.at(p_index); }                                \
+	m_type array_get(const int p_index) const { return storage.array_get(p_index); }                  \
+	void array_set(const int p_index, const m_type &p_value) { storage.array_set(p_index, p_value); } \
+                                                                                                      \
+	m_array duplicate() const {                                                                       \
+		m_array result;                                                                               \
+		storage.slice(result, 0, INT_MAX, 1);                                                         \
+		return result;                                                                                \
+	}                                                                                                 \
+                                                                                                      \
+	m_array slice(int p_begin, int p_end = INT_MAX, int p_step = 1) const {                           \
+		m_array result;                                                                               \
+		storage.slice(result, p_begin, p_end, p_step);                                                \
+		return result;                                                                                \
+	}                                                                                                 \
+                                                                                                      \
+	m_class() = default;
+
+// Declares a scriptable circular buffer of m_type, bulk reads and writes go through m_array.
+#define CIRCULAR_BUFFER_CLASS(m_class, m_type, m_array)                         \
+	class m_class : public RefCounted {                                         \
+		CIRCULAR_BUFFER_BODY(m_class, CircularStorage<m_type>, m_type, m_array) \
+	};
+
+// Same as CIRCULAR_BUFFER_CLASS, with windowed statistics. Bind them with CIRCULAR_BUFFER_BIND_STATS_METHODS.
+#define CIRCULAR_BUFFER_STATS_CLASS(m_class, m_type, m_array)                           \
+	class m_class : public RefCounted {                                                 \
+		CIRCULAR_BUFFER_BODY(m_class, CircularStatsStorage<m_type>, m_type, m_array)    \
+                                                                                        \
+	public:                                                                             \
+		CircularStatsStorage<m_type>::Sum sum() const { return storage.sum(); }         \
+		double mean() const { return storage.mean(); }                                  \
+		m_type min() const { return storage.min(); }                                    \
+		m_type max() const { return storage.max(); }                                    \
+		m_type percentile(double p_ratio) const { return storage.percentile(p_ratio); } \
+	};
+
+// Generic buffer, stores any Variant.
+CIRCULAR_BUFFER_CLASS(CircularBuffer, Variant, Array)
+
+// Typed buffers, values are stored unboxed and exchanged with scripts as packed arrays.
+CIRCULAR_BUFFER_STATS_CLASS(CircularBufferFloat, float, PackedFloat32Array)
+CIRCULAR_BUFFER_STATS_CLASS(CircularBufferInt, int64_t, PackedInt64Array)
+CIRCULAR_BUFFER_CLASS(CircularBufferVector2, Vector2, PackedVector2Array)
+CIRCULAR_BUFFER_CLASS(CircularBufferVector3, Vector3, PackedVector3Array)
+CIRCULAR_BUFFER_CLASS(CircularBufferTransform3D, Transform3D, TypedArray<Transform3D>)
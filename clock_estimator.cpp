@@ -0,0 +1,93 @@
+#include "clock_estimator.h"
+
+bool ClockEstimator::add_sample(const Sample &p_sample) {
+	ERR_FAIL_COND_V_MSG(p_sample.get_rtt() < 0, false, "Clock sample has a negative round trip.");
+
+	// keep every sample, the filter runs on the whole window
+	// so a lasting route change eventually becomes the new minimum
+	samples.append(p_sample);
+	_fit();
+
+	return p_sample.get_rtt() <= rtt_min + MAX(MIN_RTT_SPREAD, 2.0 * jitter);
+}
+
+void ClockEstimator::_fit() {
+	const uint32_t count = samples.size();
+	ERR_FAIL_COND(count == 0);
+
+	rtt_min = samples.min<RTTSorter>().get_rtt();
+	jitter = samples.median<RTTSorter>().get_rtt() - rtt_min;
+
+	// delay spikes carry up to rtt / 2 of offset error, drop them
+	const double rtt_threshold = rtt_min + MAX(MIN_RTT_SPREAD, 2.0 * jitter);
+
+	const Sample *s = samples.ptr();
+	const double origin = samples[count - 1].get_local(); // newest sample
+
+	double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+	double x_min = 0, x_max = 0;
+	accepted = 0;
+
+	for (uint32_t i = 0; i < count; i++) {
+		const double rtt = s[i].get_rtt();
+		if (rtt > rtt_threshold) {
+			continue;
+		}
+
+		const double bound = MAX(rtt / 2.0, 0.0005);
+		const double w = 1.0 / (bound * bound);
+		const double x = s[i].get_local() - origin;
+		const double y = s[i].get_offset();
+
+		sw += w;
+		sx += w * x;
+		sy += w * y;
+		sxx += w * x * x;
+		sxy += w * x * y;
+
+		x_min = accepted == 0 ? x : MIN(x_min, x);
+		x_max = accepted == 0 ? x : MAX(x_max, x);
+		accepted++;
+	}
+
+	ERR_FAIL_COND(accepted == 0); // the minimum RTT sample always passes
+
+	const double mean_x = sx / sw;
+	const double mean_y = sy / sw;
+	const double var_x = sxx / sw - mean_x * mean_x;
+
+	skew = 0;
+	if (accepted >= MIN_SKEW_SAMPLES && (x_max - x_min) >= MIN_SKEW_SPAN && var_x > CMP_EPSILON) {
+		skew = CLAMP((sxy / sw - mean_x * mean_y) / var_x, -MAX_SKEW, MAX_SKEW);
+	}
+
+	offset = mean_y - skew * mean_x;
+	reference_time = origin;
+
+	double residual = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		const double rtt = s[i].get_rtt();
+		if (rtt > rtt_threshold) {
+			continue;
+		}
+
+		const double bound = MAX(rtt / 2.0, 0.0005);
+		const double d = s[i].get_offset() - (offset + skew * (s[i].get_local() - origin));
+		residual += d * d / (bound * bound);
+	}
+	error = Math::sqrt(residual / sw);
+
+	valid = true;
+}
+
+void ClockEstimator::reset() {
+	samples.clear();
+	offset = 0;
+	skew = 0;
+	reference_time = 0;
+	error = 0;
+	rtt_min = 0;
+	jitter = 0;
+	accepted = 0;
+	valid = false;
+}
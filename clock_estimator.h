@@ -0,0 +1,68 @@
+#pragma once
+
+#include "tinystuff.h"
+
+/**
+ * Estimates the offset and the frequency drift between the local and a remote clock.
+ *
+ * Samples are request/response round trips timed with the raw local clock.
+ * NTP-style, the round trip bounds the error of each sample, so only the
+ * samples close to the minimum RTT of the window are trusted. A weighted least
+ * squares fit over them gives the offset and the skew, which lets the clock
+ * be corrected between samples and the sampling rate back off once stable.
+ */
+class ClockEstimator {
+public:
+	struct Sample {
+		double local_sent = 0; // raw local clock when the request was sent
+		double local_received = 0; // raw local clock when the response was received
+		double remote = 0; // remote clock when the request was handled
+
+		double get_rtt() const { return local_received - local_sent; }
+		double get_local() const { return (local_sent + local_received) / 2.0; }
+		double get_offset() const { return remote - get_local(); }
+	};
+
+private:
+	struct RTTSorter {
+		_ALWAYS_INLINE_ bool operator()(const Sample &l, const Sample &r) const {
+			return l.get_rtt() < r.get_rtt();
+		}
+	};
+
+	static constexpr uint32_t WINDOW = 32;
+	static constexpr double MIN_RTT_SPREAD = 0.002; // always trust samples this close to the minimum RTT
+	static constexpr uint32_t MIN_SKEW_SAMPLES = 4;
+	static constexpr double MIN_SKEW_SPAN = 2.0; // seconds of history before estimating the skew
+	static constexpr double MAX_SKEW = 0.0005; // 500 ppm, anything above is not a clock drift
+	static constexpr uint32_t CONFIDENT_SAMPLES = 6;
+	static constexpr double CONFIDENT_ERROR = 0.002;
+
+	FixedBuffer<Sample> samples{ WINDOW, true };
+
+	double offset = 0; // remote - local at reference_time
+	double skew = 0; // drift of the offset, in seconds per second
+	double reference_time = 0;
+	double error = 0; // weighted rms residual of the fit
+	double rtt_min = 0;
+	double jitter = 0;
+	uint32_t accepted = 0;
+	bool valid = false;
+
+	void _fit();
+
+public:
+	// Returns false if the sample has been rejected as an outlier.
+	bool add_sample(const Sample &p_sample);
+	void reset();
+
+	bool is_valid() const { return valid; }
+	bool is_confident() const { return valid && accepted >= CONFIDENT_SAMPLES && error < CONFIDENT_ERROR; }
+
+	// Estimated remote - local offset at the given raw local time.
+	double get_offset(double p_local_time) const { return offset + skew * (p_local_time - reference_time); }
+	double get_skew() const { return skew; }
+	double get_error() const { return error; }
+	double get_rtt() const { return rtt_min; }
+	double get_jitter() const { return jitter; }
+};
@@ -16,4 +16,10 @@ def get_doc_path():
 def get_doc_classes():
     return [
         "CircularBuffer",
+        "CircularBufferFloat",
+        "CircularBufferInt",
+        "CircularBufferVector2",
+        "CircularBufferVector3",
+        "CircularBufferTransform3D",
+        "SPSCCircularBuffer",
     ]
@@ -100,6 +100,87 @@ void NetworkInputEditor::_tree_button_pressed(Object *p_item, int p_column, int
 	delete_dialog->popup_centered();
 }
 
+void NetworkInputEditor::_tree_item_edited() {
+	TreeItem *ti = tree->get_edited();
+	if (!ti || config.is_null()) {
+		return;
+	}
+
+	const int column = tree->get_edited_column();
+	const NodePath prop = ti->get_metadata(0);
+	EditorUndoRedoManager *undo_redo = EditorUndoRedoManager::get_singleton();
+
+	if (column == 2) {
+		const int idx = int(ti->get_range(2));
+		const NetworkInputReplicaConfig::PropertyPrecision precision = idx < ENCODING_QUANTIZED ? NetworkInputReplicaConfig::PropertyPrecision(idx) : config->property_get_precision(prop);
+		const int bits = idx < ENCODING_QUANTIZED ? 0 : QUANTIZATION_BITS[idx - ENCODING_QUANTIZED];
+
+		undo_redo->create_action(TTR("Set Input Encoding"));
+		undo_redo->add_do_method(config.ptr(), "property_set_precision", prop, precision);
+		undo_redo->add_do_method(config.ptr(), "property_set_quantization_bits", prop, bits);
+		undo_redo->add_undo_method(config.ptr(), "property_set_precision", prop, config->property_get_precision(prop));
+		undo_redo->add_undo_method(config.ptr(), "property_set_quantization_bits", prop, config->property_get_quantization_bits(prop));
+	} else if (column == 3) {
+		const PackedStringArray range = ti->get_text(3).split(",");
+		const double min = range.size() == 2 ? range[0].strip_edges().to_float() : 0.0;
+		const double max = range.size() == 2 ? range[1].strip_edges().to_float() : 0.0;
+		if (range.size() != 2 || min >= max) {
+			EditorNode::get_singleton()->show_warning(TTR("The range must be two numbers, \"min, max\", with min lower than max."));
+			callable_mp(this, &NetworkInputEditor::_update_config).call_deferred();
+			return;
+		}
+
+		undo_redo->create_action(TTR("Set Input Range"));
+		undo_redo->add_do_method(config.ptr(), "property_set_range", prop, min, max);
+		undo_redo->add_undo_method(config.ptr(), "property_set_range", prop, config->property_get_range_min(prop), config->property_get_range_max(prop));
+	} else if (column == 4) {
+		undo_redo->create_action(TTR("Set Input Deadzone"));
+		undo_redo->add_do_method(config.ptr(), "property_set_deadzone", prop, ti->get_range(4));
+		undo_redo->add_undo_method(config.ptr(), "property_set_deadzone", prop, config->property_get_deadzone(prop));
+	} else {
+		return;
+	}
+
+	undo_redo->add_do_method(this, "_update_config");
+	undo_redo->add_undo_method(this, "_update_config");
+	undo_redo->commit_action();
+}
+
+int NetworkInputEditor::_get_property_size_in_bits(const NodePath &p_property, Variant::Type p_type) const {
+	const int components = get_real_components(p_type);
+	if (components == 0 || config.is_null() || !config->has_property(p_property)) {
+		return get_type_size_in_bits(p_type);
+	}
+
+	const int bits = config->property_get_quantization_bits(p_property);
+	if (bits > 0) {
+		return components * bits;
+	}
+
+	switch (config->property_get_precision(p_property)) {
+		case NetworkInputReplicaConfig::PRECISION_HALF:
+			return components * 16;
+		case NetworkInputReplicaConfig::PRECISION_SINGLE:
+			return components * 32;
+		default:
+			return p_type == Variant::FLOAT ? 64 : components * (sizeof(real_t) * 8);
+	}
+}
+
+int NetworkInputEditor::_get_encoding_index(const NodePath &p_property) const {
+	const int bits = config->property_get_quantization_bits(p_property);
+	if (bits == 0) {
+		return int(config->property_get_precision(p_property));
+	}
+
+	for (int i = 0; i < int(std::size(QUANTIZATION_BITS)); i++) {
+		if (QUANTIZATION_BITS[i] >= bits) {
+			return ENCODING_QUANTIZED + i;
+		}
+	}
+	return ENCODING_QUANTIZED + int(std::size(QUANTIZATION_BITS)) - 1;
+}
+
 struct PropertySizeSort {
 	_ALWAYS_INLINE_ bool operator()(const Pair<NodePath, Pair<int, int>> &a, const Pair<NodePath, Pair<int, int>> &b) const {
 		if (a.second.first != b.second.first) {
@@ -119,7 +200,7 @@ void NetworkInputEditor::_optimize_pressed() {
 	for (int i = 0; i < props.size(); i++) {
 		const NodePath path = props[i];
 		const Variant &prop_value = current ? current->get_indexed(path.get_names()) : Variant();
-		int s = get_type_size_in_bits(prop_value.get_type());
+		int s = _get_property_size_in_bits(path, prop_value.get_type());
 		prop_sizes.push_back(Pair<NodePath, Pair<int, int>>(path, Pair<int, int>(s, i)));
 	}
 
@@ -160,7 +241,7 @@ void NetworkInputEditor::_update_config() {
 
 		//
 		const Variant &prop_value = current ? current->get_indexed(path.get_names()) : Variant();
-		int s = get_type_size_in_bits(prop_value.get_type());
+		int s = _get_property_size_in_bits(path, prop_value.get_type());
 
 		state_vars.write[i] = prop_value;
 		varp.write[i] = &state_vars[i];
@@ -201,15 +282,17 @@ void NetworkInputEditor::_add_property(const NodePath &p_property) {
 	item->set_selectable(2, false);
 	item->set_selectable(3, false);
 	item->set_selectable(4, false);
+	item->set_selectable(5, false);
+	item->set_selectable(6, false);
 	item->set_text(0, prop);
 	item->set_metadata(0, prop);
 
-	item->set_text_alignment(3, HORIZONTAL_ALIGNMENT_CENTER);
-	item->set_cell_mode(3, TreeItem::CELL_MODE_CHECK);
-	item->set_checked(3, false);
-	item->set_editable(3, true);
+	item->set_text_alignment(5, HORIZONTAL_ALIGNMENT_CENTER);
+	item->set_cell_mode(5, TreeItem::CELL_MODE_CHECK);
+	item->set_checked(5, false);
+	item->set_editable(5, true);
 
-	item->add_button(4, get_theme_icon(SNAME("Remove"), EditorStringName(EditorIcons)));
+	item->add_button(6, get_theme_icon(SNAME("Remove"), EditorStringName(EditorIcons)));
 
 	bool prop_valid = false;
 	const Variant &prop_value = current ? current->get_indexed(p_property.get_names(), &prop_valid) : Variant();
@@ -221,7 +304,33 @@ void NetworkInputEditor::_add_property(const NodePath &p_property) {
 		item->set_icon(1, get_theme_icon(SNAME("ImportFail"), EditorStringName(EditorIcons)));
 	}
 
-	item->set_text(2, vformat("%d-bit", get_type_size_in_bits(prop_value.get_type())));
+	// only float components can be quantized
+	if (get_real_components(prop_value.get_type()) > 0 && config.is_valid() && config->has_property(p_property)) {
+		const bool quantized = config->property_get_quantization_bits(p_property) > 0;
+
+		String options = TTR("Full") + "," + TTR("Single") + "," + TTR("Half");
+		for (int bits : QUANTIZATION_BITS) {
+			options += "," + vformat(TTR("%d-bit Fixed"), bits);
+		}
+
+		item->set_cell_mode(2, TreeItem::CELL_MODE_RANGE);
+		item->set_text(2, options);
+		item->set_range(2, _get_encoding_index(p_property));
+		item->set_editable(2, true);
+		item->set_tooltip_text(2, vformat(TTR("%d bits per frame."), _get_property_size_in_bits(p_property, prop_value.get_type())));
+
+		item->set_text(3, vformat("%s, %s", String::num(config->property_get_range_min(p_property)), String::num(config->property_get_range_max(p_property))));
+		item->set_editable(3, quantized);
+		item->set_tooltip_text(3, TTR("Quantization range, values are clamped to it."));
+
+		item->set_cell_mode(4, TreeItem::CELL_MODE_RANGE);
+		item->set_range_config(4, 0.0, 1.0, 0.01);
+		item->set_range(4, config->property_get_deadzone(p_property));
+		item->set_editable(4, true);
+		item->set_tooltip_text(4, TTR("Values closer to zero than the deadzone are sent as zero, radial for vectors."));
+	} else {
+		item->set_text(2, vformat("%d-bit", _get_property_size_in_bits(p_property, prop_value.get_type())));
+	}
 }
 
 void NetworkInputEditor::_dialog_closed(bool p_confirmed) {
@@ -374,7 +483,7 @@ NetworkInputEditor::NetworkInputEditor() {
 
 	tree = memnew(Tree);
 	tree->set_hide_root(true);
-	tree->set_columns(5);
+	tree->set_columns(7);
 	tree->set_column_titles_visible(true);
 	tree->set_column_title(0, TTR("Properties"));
 	tree->set_column_expand(0, true);
@@ -384,13 +493,19 @@ NetworkInputEditor::NetworkInputEditor() {
 	tree->set_column_title(2, TTR("Encoding"));
 	tree->set_column_custom_minimum_width(2, 100);
 	tree->set_column_expand(2, false);
-	tree->set_column_title(3, TTR("Sample"));
+	tree->set_column_title(3, TTR("Range"));
 	tree->set_column_custom_minimum_width(3, 100);
 	tree->set_column_expand(3, false);
+	tree->set_column_title(4, TTR("Deadzone"));
+	tree->set_column_custom_minimum_width(4, 80);
 	tree->set_column_expand(4, false);
+	tree->set_column_title(5, TTR("Sample"));
+	tree->set_column_custom_minimum_width(5, 100);
+	tree->set_column_expand(5, false);
+	tree->set_column_expand(6, false);
 	tree->create_item();
 	tree->connect("button_clicked", callable_mp(this, &NetworkInputEditor::_tree_button_pressed));
-	// tree->connect("item_edited", callable_mp(this, &NetworkInputEditor::_tree_item_edited));
+	tree->connect("item_edited", callable_mp(this, &NetworkInputEditor::_tree_item_edited));
 	tree->set_v_size_flags(SIZE_EXPAND_FILL);
 	vb->add_child(tree);
 
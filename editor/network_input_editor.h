@@ -52,6 +52,28 @@ private:
 		}
 	}
 
+	static int get_real_components(Variant::Type p_type) {
+		switch (p_type) {
+			case Variant::FLOAT:
+				return 1;
+			case Variant::VECTOR2:
+				return 2;
+			case Variant::VECTOR3:
+				return 3;
+			case Variant::VECTOR4:
+				return 4;
+			default:
+				return 0;
+		}
+	}
+
+	// encoding column options, full/single/half precision then the quantized bit depths
+	static constexpr int ENCODING_QUANTIZED = 3;
+	static constexpr int QUANTIZATION_BITS[] = { 4, 8, 10, 12, 16 };
+
+	int _get_property_size_in_bits(const NodePath &p_property, Variant::Type p_type) const;
+	int _get_encoding_index(const NodePath &p_property) const;
+
 	NetworkInput *current = nullptr;
 	Ref<NetworkInputReplicaConfig> config;
 	NodePath deleting;
@@ -71,6 +93,7 @@ private:
 	void _dialog_closed(bool p_confirmed);
 	void _add_property(const NodePath &p_property);
 	void _tree_button_pressed(Object *p_item, int p_column, int p_id, MouseButton p_button);
+	void _tree_item_edited();
 	void _optimize_pressed();
 
 	Variant get_drag_data_fw(const Point2 &p_point, Control *p_from);
@@ -0,0 +1,90 @@
+#include "input_frame_codec.h"
+
+Error InputFrameCodec::encode(const InputSchema &p_schema, const InputFrame *p_frames, int p_frames_count, LocalVector<uint8_t> &r_buffer, int p_offset, int &r_size) {
+	const int slot_count = p_schema.size();
+	ERR_FAIL_COND_V(slot_count == 0, ERR_UNCONFIGURED);
+	ERR_FAIL_COND_V(p_frames_count <= 0, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_offset < 0, ERR_INVALID_PARAMETER);
+
+	// single pass, the bits land in the packet directly
+	InputBitWriter writer(r_buffer, p_offset);
+
+	const InputFrame *prev = nullptr;
+	for (int i = 0; i < p_frames_count; i++) {
+		const InputFrame &frame = p_frames[i];
+
+		if (prev) {
+			ERR_FAIL_COND_V_MSG(frame.frame_id <= prev->frame_id, ERR_INVALID_DATA, "Input frames are not consecutive.");
+			writer.write_varint(frame.frame_id - prev->frame_id);
+		} else {
+			writer.write_varint(frame.frame_id);
+		}
+
+		ERR_FAIL_COND_V_MSG(frame.values.size() != uint32_t(slot_count), ERR_INVALID_DATA, "Input frame does not match the schema.");
+
+		uint64_t changed = 0;
+		for (int j = 0; j < slot_count; j++) {
+			if (prev && prev->values[j].hash_compare(frame.values[j])) {
+				continue; // unchanged
+			}
+			changed |= uint64_t(1) << j;
+		}
+
+		if (prev) {
+			writer.write_bits(changed, slot_count);
+		}
+
+		for (int j = 0; j < slot_count; j++) {
+			if (changed & (uint64_t(1) << j)) {
+				Error err = p_schema.write(writer, j, frame.values[j]);
+				ERR_FAIL_COND_V(err != OK, err);
+			}
+		}
+
+		prev = &frame;
+	}
+
+	r_size = writer.get_size() - p_offset;
+	return OK;
+}
+
+Error InputFrameCodec::decode(const InputSchema &p_schema, int p_frames_count, const uint8_t *p_buffer, int p_len, LocalVector<Variant> &r_values, LocalVector<InputFrame> &r_frames) {
+	const int slot_count = p_schema.size();
+	ERR_FAIL_COND_V(slot_count == 0, ERR_UNCONFIGURED);
+	ERR_FAIL_COND_V(p_frames_count <= 0, ERR_INVALID_PARAMETER);
+
+	InputBitReader reader(p_buffer, p_len);
+	r_values.resize(p_frames_count * slot_count);
+	r_frames.resize(p_frames_count);
+
+	for (int i = 0; i < p_frames_count; i++) {
+		InputFrame &frame = r_frames[i];
+		Variant *row = r_values.ptr() + i * slot_count;
+		frame.values = Span<Variant>(row, slot_count);
+
+		uint64_t changed = UINT64_MAX;
+		if (i == 0) {
+			frame.frame_id = reader.read_varint();
+		} else {
+			const uint64_t delta = reader.read_varint();
+			ERR_FAIL_COND_V_MSG(delta == 0, ERR_INVALID_DATA, "Input frames are not consecutive.");
+
+			frame.frame_id = r_frames[i - 1].frame_id + delta;
+			for (int j = 0; j < slot_count; j++) {
+				row[j] = row[j - slot_count]; // unchanged values carry over from the previous row
+			}
+			changed = reader.read_bits(slot_count);
+		}
+
+		for (int j = 0; j < slot_count; j++) {
+			if (changed & (uint64_t(1) << j)) {
+				Error err = p_schema.read(reader, j, row[j]);
+				ERR_FAIL_COND_V(err != OK, err);
+			}
+		}
+
+		ERR_FAIL_COND_V_MSG(reader.has_overflowed(), ERR_INVALID_DATA, "Input packet is truncated.");
+	}
+
+	return OK;
+}
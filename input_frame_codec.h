@@ -0,0 +1,25 @@
+#pragma once
+
+#include "input_schema.h"
+#include "network_input.h"
+
+#include "core/templates/local_vector.h"
+
+/**
+ * Wire format for a run of consecutive input frames.
+ *
+ * Inputs rarely change between ticks, so only the first frame is written in
+ * full, every later frame is a frame id delta and a bitmask of the properties
+ * that changed since the previous frame, followed by those values only.
+ *
+ * Everything is bit packed through the InputSchema of the input: the base
+ * frame id as a varint, then per later frame the delta as a varint and one
+ * bit per property, each frame followed by its values.
+ */
+class InputFrameCodec {
+public:
+	// Writes the frames straight into r_buffer at p_offset, r_buffer is truncated to the end of the frames.
+	static Error encode(const InputSchema &p_schema, const InputFrame *p_frames, int p_frames_count, LocalVector<uint8_t> &r_buffer, int p_offset, int &r_size);
+	// Decodes the rows into r_values, flat, and r_frames views them, both keep their capacity between calls.
+	static Error decode(const InputSchema &p_schema, int p_frames_count, const uint8_t *p_buffer, int p_len, LocalVector<Variant> &r_values, LocalVector<InputFrame> &r_frames);
+};
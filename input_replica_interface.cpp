@@ -1,5 +1,9 @@
 #include "input_replica_interface.h"
+#include "input_frame_codec.h"
+
 #include "core/io/marshalls.h"
+#include "core/os/os.h"
+#include "network.h"
 #include "network_input.h"
 #include "rollback_multiplayer.h"
 
@@ -8,8 +12,81 @@ void InputReplicaInterface::_input_ready(const ObjectID &p_oid) {
 	ERR_FAIL_NULL(input); // should never happen
 
 	// only track add autoritative inputs
-	if (input->is_input_authority()) {
-		inputs.insert(p_oid, InputState());
+	if (!input->is_input_authority()) {
+		return;
+	}
+
+	_input_removed(p_oid); // in case it was already tracked
+
+	InputState state;
+	state.input = input;
+	state.oid = p_oid;
+	state.input_id = input->get_input_id();
+	state.peer = input->get_multiplayer_authority();
+	state.local = input->is_multiplayer_authority();
+
+	const uint32_t index = inputs.size();
+	inputs.push_back(state);
+	input_indices.insert(p_oid, index);
+	peer_inputs[state.peer].push_back(index);
+}
+
+void InputReplicaInterface::_input_removed(const ObjectID &p_oid) {
+	const uint32_t *index = input_indices.getptr(p_oid);
+	if (!index) {
+		return;
+	}
+
+	const uint32_t removed = *index;
+	input_indices.erase(p_oid);
+
+	LocalVector<uint32_t> *owned = peer_inputs.getptr(inputs[removed].peer);
+	if (owned) {
+		owned->erase(removed);
+		if (owned->is_empty()) {
+			peer_inputs.erase(inputs[removed].peer);
+		}
+	}
+
+	if (walking) {
+		// the indices stay put until the walk is over
+		inputs[removed].input = nullptr;
+		removals_pending = true;
+		return;
+	}
+
+	// the last input fills the hole
+	const uint32_t last = inputs.size() - 1;
+	if (removed != last) {
+		const InputState &moved = inputs[last];
+		input_indices[moved.oid] = removed;
+
+		LocalVector<uint32_t> &moved_owned = peer_inputs[moved.peer];
+		const int64_t i = moved_owned.find(last);
+		if (i >= 0) {
+			moved_owned[i] = removed;
+		}
+	}
+
+	inputs.remove_at_unordered(removed);
+}
+
+void InputReplicaInterface::_compact_inputs() {
+	removals_pending = false;
+
+	uint32_t kept = 0;
+	for (uint32_t i = 0; i < inputs.size(); i++) {
+		if (inputs[i].input) {
+			inputs[kept++] = inputs[i];
+		}
+	}
+	inputs.resize(kept);
+
+	input_indices.clear();
+	peer_inputs.clear();
+	for (uint32_t i = 0; i < inputs.size(); i++) {
+		input_indices.insert(inputs[i].oid, i);
+		peer_inputs[inputs[i].peer].push_back(i);
 	}
 }
 
@@ -20,6 +97,7 @@ Error InputReplicaInterface::add_input(Object *p_obj, Variant p_config) {
 	ERR_FAIL_NULL_V(input, ERR_INVALID_PARAMETER);
 
 	const ObjectID oid = input->get_instance_id();
+	registered.insert(oid);
 
 	// delay the initialization until the node is ready
 	// this will give a chance for the input to configure it's own authority
@@ -38,165 +116,372 @@ Error InputReplicaInterface::remove_input(Object *p_obj, Variant p_config) {
 	NetworkInput *input = Object::cast_to<NetworkInput>(p_config.get_validated_object());
 	ERR_FAIL_NULL_V(input, ERR_INVALID_PARAMETER);
 
-	const ObjectID oid = input->get_instance_id();
-	inputs.erase(oid);
+	registered.erase(input->get_instance_id());
+	_input_removed(input->get_instance_id());
 	return OK;
 }
 
+void InputReplicaInterface::rebuild_inputs() {
+	server = multiplayer->is_server();
+
+	// the authority and the locality of every input depend on the unique id, a new session starts the acks over
+	inputs.clear();
+	input_indices.clear();
+	peer_inputs.clear();
+	peer_echoes.clear();
+	for (const ObjectID &oid : registered) {
+		NetworkInput *input = ObjectDB::get_instance<NetworkInput>(oid);
+		if (input && input->is_ready()) {
+			_input_ready(oid); // otherwise the ready callback is still pending
+		}
+	}
+
+	packet_sequence = 0;
+	loss_sequence = 0;
+	loss_received = 0;
+	loss_started = false;
+	loss = 0;
+}
+
+void InputReplicaInterface::get_peer_inputs(int p_peer, LocalVector<NetworkInput *> &r_inputs) const {
+	r_inputs.clear();
+	const LocalVector<uint32_t> *owned = peer_inputs.getptr(p_peer);
+	if (!owned) {
+		return;
+	}
+	for (const uint32_t index : *owned) {
+		ERR_CONTINUE(index >= inputs.size() || inputs[index].peer != p_peer);
+		r_inputs.push_back(inputs[index].input);
+	}
+}
+
 void InputReplicaInterface::capture_inputs() {
-	for (KeyValue<ObjectID, InputState> &E : inputs) {
-		const ObjectID &oid = E.key;
-		NetworkInput *input = oid.is_valid() ? ObjectDB::get_instance<NetworkInput>(oid) : nullptr;
+	// by index, a script may add or remove inputs while gathering
+	walking = true;
+	for (uint32_t i = 0; i < inputs.size(); i++) {
+		NetworkInput *input = inputs[i].input;
 		if (!input) {
-			continue;
+			continue; // removed during this walk
 		}
 
-		if (input->is_multiplayer_authority()) { // only gather local authority
+		if (inputs[i].local) { // only gather local authority
 			input->gather();
-		} else if (multiplayer->is_server()) {
+		} else if (server) {
 			input->replay(); // replay from buffer on server
 		}
 	}
+	walking = false;
+
+	if (removals_pending) {
+		_compact_inputs();
+	}
 }
 void InputReplicaInterface::release_inputs() {
-	// only the client can send
+	// frames in between network ticks go out in the next batch
+	if (!Network::get_singleton()->is_network_tick()) {
+		return;
+	}
+
 	if (multiplayer->get_rollback_state() == RollbackMultiplayer::ROLLBACK_STATE_CLIENT) {
+		if (!multiplayer->is_clock_synchronized()) {
+			return; // frame ids mean nothing to the server before the clock bootstrap
+		}
 		_send_local_inputs();
+	} else if (multiplayer->get_rollback_state() == RollbackMultiplayer::ROLLBACK_STATE_SERVER) {
+		_send_input_acks();
 	}
 }
 
-Error InputReplicaInterface::_send_local_inputs() {
-	NetworkInput *input = nullptr;
-	for (const KeyValue<ObjectID, InputState> &E : inputs) {
-		const ObjectID &oid = E.key;
-		NetworkInput *i = oid.is_valid() ? ObjectDB::get_instance<NetworkInput>(oid) : nullptr;
-		if (i && i->is_multiplayer_authority()) {
-			input = i;
-			break; // HACK: only send the first input we find, ideally multiple inputs should be supported
+Error InputReplicaInterface::_send_input_acks() {
+	for (KeyValue<int, PeerEcho> &P : peer_echoes) {
+		PeerEcho &echo = P.value;
+		if (!echo.pending) {
+			continue;
 		}
-	}
+		echo.pending = false;
 
-	if (!input) {
-		return OK; // nothing to send
+		const int peer = P.key;
+
+		if (packet_cache.size() < uint32_t(INPUT_ACK_HEADER_SIZE + 2)) {
+			packet_cache.resize(INPUT_ACK_HEADER_SIZE + 2);
+		}
+
+		uint8_t *ptr = packet_cache.ptr();
+		ptr[0] = SceneMultiplayer::NETWORK_COMMAND_RAW | RollbackMultiplayer::CMD_FLAG_PING_PONG_SHIFT;
+		ptr[1] = RollbackMultiplayer::COMMAND_INPUT_ACK;
+
+		// the client removes the time the stamp spent here from the round trip
+		const uint64_t hold_usec = OS::get_singleton()->get_ticks_usec() - echo.received_usec;
+
+		encode_uint32(echo.stamp, &ptr[2]);
+		encode_uint32(uint32_t(MIN(hold_usec, uint64_t(UINT32_MAX))), &ptr[6]);
+		encode_double(echo.received_time, &ptr[10]); // server clock when the stamp arrived
+
+		// speed up/slow down, in ticks
+		const RollbackMultiplayer::PeerTiming *timing = multiplayer->peer_timings.getptr(peer);
+		encode_half(timing ? timing->get_lead_hint() : 0.0, &ptr[18]);
+
+		encode_uint16(echo.sequence, &ptr[20]);
+		encode_uint32(echo.received, &ptr[22]);
+
+		// highest contiguous frame received, per input
+		int offset = INPUT_ACK_HEADER_SIZE + 2;
+		uint8_t count = 0;
+		const LocalVector<uint32_t> *owned = peer_inputs.getptr(peer);
+		for (uint32_t i = 0; owned && i < owned->size(); i++) {
+			const InputState &state = inputs[(*owned)[i]];
+			if (state.last_aknownedged_input_id == 0) {
+				continue;
+			}
+			if (count == INPUT_SECTIONS_MAX) {
+				break;
+			}
+
+			if (packet_cache.size() < uint32_t(offset + INPUT_ACK_ENTRY_SIZE)) {
+				packet_cache.resize(offset + INPUT_ACK_ENTRY_SIZE);
+			}
+			ptr = packet_cache.ptr();
+			encode_uint32(state.input_id, &ptr[offset]);
+			encode_uint64(state.last_aknownedged_input_id, &ptr[offset + 4]);
+			offset += INPUT_ACK_ENTRY_SIZE;
+			count++;
+		}
+		ptr[INPUT_ACK_HEADER_SIZE + 1] = count;
+
+		Error err = _send_raw(packet_cache.ptr(), offset, peer, false);
+		ERR_FAIL_COND_V(err != OK, err);
 	}
 
-	Ref<NetworkInputReplicaConfig> replica_config = input->get_replica_config();
-	ERR_FAIL_COND_V(replica_config.is_null(), ERR_UNCONFIGURED);
+	return OK;
+}
 
-	const Vector<NodePath> props = replica_config->get_replica_properties();
-	ERR_FAIL_COND_V(props.is_empty(), ERR_UNCONFIGURED);
+int InputReplicaInterface::_get_redundancy() const {
+	// zero on a clean link, only the unacknowledged frames go out
+	return MIN(int(Math::ceil(loss * REDUNDANCY_PER_LOSS)), REDUNDANCY_MAX);
+}
 
-	Vector<InputFrame> frames;
-	Error err = input->copy_buffer(frames, 4);
-	ERR_FAIL_COND_V_MSG(err != OK, err, "Unable to copy input buffer.");
+void InputReplicaInterface::_track_loss(uint16_t p_sequence, uint32_t p_received) {
+	if (!loss_started) {
+		loss_started = true;
+		loss_sequence = p_sequence;
+		loss_received = p_received;
+		return;
+	}
 
-	if (frames.is_empty()) {
-		return OK; // nothing to send
+	const int16_t sent = int16_t(p_sequence - loss_sequence);
+	if (sent < int16_t(LOSS_WINDOW)) {
+		return; // older ack, or not enough packets yet
 	}
 
-	Vector<Variant> state_vars;
-	Vector<const Variant *> varp;
+	const double ratio = CLAMP(1.0 - double(p_received - loss_received) / double(sent), 0.0, 1.0);
+	loss += (ratio - loss) * LOSS_SMOOTHING;
+	loss_sequence = p_sequence;
+	loss_received = p_received;
+}
 
-	state_vars.resize(frames.size() * (props.size() + 1)); // +1 for frame_id
-	varp.resize(state_vars.size());
+Error InputReplicaInterface::_send_local_inputs() {
+	// every frame the server has not acknowledged, the acks are contiguous so a lost packet is resent until it gets through
+	// a lossy link adds the redundancy on top, in case the acks themselves get lost
+	const int redundancy = _get_redundancy();
+
+	int offset = INPUT_HEADER_SIZE;
+	int sections = 0;
 
-	for (int i = 0; i < frames.size(); i++) {
-		int offset = i * (props.size() + 1);
+	for (InputState &state : inputs) {
+		NetworkInput *input = state.input;
+		if (!state.local || input->get_schema().is_empty()) {
+			continue;
+		}
 
-		const InputFrame &frame = frames[i];
-		state_vars.write[offset] = frame.frame_id;
-		varp.write[offset] = &state_vars[offset];
+		const uint64_t newest_frame_id = uint64_t(input->get_current_frame());
+		if (newest_frame_id <= state.last_acked_frame_id) {
+			continue; // nothing new
+		}
 
-		for (int j = 0; j < props.size(); j++) {
-			const NodePath &prop = props[j];
-			ERR_FAIL_COND_V_MSG(!frame.properties.has(prop), ERR_DOES_NOT_EXIST, vformat("Property '%s' not found in input frame.", prop));
+		const int frames_count = int(MIN(newest_frame_id - state.last_acked_frame_id + redundancy, uint64_t(INPUT_FRAMES_MAX)));
 
-			state_vars.write[offset + 1 + j] = frame.properties[prop];
-			varp.write[offset + 1 + j] = &state_vars[offset + 1 + j];
+		// the frames are read in place, no copy
+		if (input->get_buffered_frames(frames_count, frames_cache) == 0) {
+			continue;
 		}
-	}
 
-	int size;
-	err = MultiplayerAPI::encode_and_compress_variants(varp.ptrw(), varp.size(), nullptr, size);
-	ERR_FAIL_COND_V_MSG(err != OK, err, "Unable to encode input buffer.");
+		int size;
+		Error err = InputFrameCodec::encode(input->get_schema(), frames_cache.ptr(), frames_cache.size(), packet_cache, offset + INPUT_SECTION_HEADER_SIZE, size);
+		ERR_CONTINUE_MSG(err != OK, "Unable to encode input buffer.");
+		ERR_CONTINUE_MSG(size > UINT16_MAX, "Input section is too large."); // the next section overwrites it
+
+		uint8_t *ptr = packet_cache.ptr() + offset;
+		encode_uint32(state.input_id, &ptr[0]);
+		ptr[4] = uint8_t(frames_cache.size());
+		encode_uint16(uint16_t(size), &ptr[5]);
+
+		offset += INPUT_SECTION_HEADER_SIZE + size;
+		if (++sections == INPUT_SECTIONS_MAX) {
+			break;
+		}
+	}
 
-	if (packet_cache.size() < 2 + size) {
-		packet_cache.resize(2 + size);
+	if (sections == 0) {
+		return OK; // nothing to send
 	}
 
-	uint8_t *ptr = packet_cache.ptrw();
+	uint8_t *ptr = packet_cache.ptr();
 	ptr[0] = SceneMultiplayer::NETWORK_COMMAND_RAW | 1 << SceneMultiplayer::CMD_FLAG_1_SHIFT;
-	ptr[1] = uint8_t(frames.size());
-	MultiplayerAPI::encode_and_compress_variants(varp.ptrw(), varp.size(), &ptr[2], size);
+	ptr[1] = uint8_t(sections);
+	encode_uint32(uint32_t(OS::get_singleton()->get_ticks_usec()), &ptr[2]); // clock stamp, the server echoes it back
+	encode_uint16(packet_sequence++, &ptr[6]);
 
-	return _send_raw(packet_cache.ptr(), (2 + size), 1, false); // send to server
+	return _send_raw(packet_cache.ptr(), offset, 1, false); // send to server
 }
 
 void InputReplicaInterface::process_inputs(int p_from, const uint8_t *p_packet, int p_packet_len) {
-	ERR_FAIL_COND(!multiplayer->is_server());
+	ERR_FAIL_COND(!server);
 
 	ERR_FAIL_COND_MSG(p_from == 1, "Input packets should only come from peers.");
-	ERR_FAIL_COND_MSG(p_packet_len < 2, "Invalid input packet received. Size too small.");
-
-	const uint8_t frames_count = p_packet[1];
-	ERR_FAIL_COND_MSG(frames_count == 0, "Input packet contains zero frames.");
-	ERR_FAIL_COND_MSG(frames_count > 64, "Input packet contains too many frames.");
-
-	// find the input owner
-	NetworkInput *input = nullptr;
-	InputState *input_state = nullptr;
-	for (const KeyValue<ObjectID, InputState> &E : inputs) {
-		input = E.key.is_valid() ? ObjectDB::get_instance<NetworkInput>(E.key) : nullptr;
-		if (input && input->get_multiplayer_authority() == p_from) {
-			input = input;
-			input_state = &inputs[E.key];
-			break;
-		}
-	}
+	ERR_FAIL_COND_MSG(p_packet_len < INPUT_HEADER_SIZE, "Invalid input packet received. Size too small.");
 
-	ERR_FAIL_COND_MSG(!input || !input_state, "Received input packet from unknown peer.");
-	Ref<NetworkInputReplicaConfig> replica_config = input->get_replica_config();
-	ERR_FAIL_COND_MSG(replica_config.is_null(), "Received input from peer with no configured replica.");
-	const Vector<NodePath> props = replica_config->get_replica_properties();
-	ERR_FAIL_COND_MSG(props.is_empty(), "Received input from peer with no configured properties.");
+	const uint8_t sections = p_packet[1];
+	ERR_FAIL_COND_MSG(sections == 0, "Input packet contains no inputs.");
 
-	// ERR_FAIL_COND_MSG(input_state->input_buffer.space_left() < frames_count, "Not enough space in input buffer to store received input frames.");
+	// the inputs owned by this peer
+	const LocalVector<uint32_t> *owned = peer_inputs.getptr(p_from);
+	ERR_FAIL_COND_MSG(!owned, "Received input packet from unknown peer.");
 
-	const int64_t prop_size = props.size();
-	int varc = frames_count * (prop_size + 1); // +1 is tick
+	// stamp for the clock of the client, echoed on the next network tick
+	PeerEcho &echo = peer_echoes[p_from];
+	echo.stamp = decode_uint32(&p_packet[2]);
+	echo.received_usec = OS::get_singleton()->get_ticks_usec();
+	echo.received_time = Network::get_singleton()->get_reference_clock()->get_precise_time();
+	echo.pending = true;
 
-	ERR_FAIL_COND_MSG(varc <= 0 || varc > 1024, "Input packet contains too much data"); // 1024 hold over 100 props for 8 frames
+	const uint16_t sequence = decode_uint16(&p_packet[6]);
+	if (echo.received == 0 || int16_t(sequence - echo.sequence) > 0) {
+		echo.sequence = sequence;
+	}
+	echo.received++;
+
+	// the lead is sampled once per packet on its newest frame, the resent frames would bias it low
+	bool has_lead = false;
+	int64_t lead = 0;
+	int target_depth = 0;
+
+	int offset = INPUT_HEADER_SIZE;
+	for (int i = 0; i < sections; i++) {
+		ERR_FAIL_COND_MSG(offset + INPUT_SECTION_HEADER_SIZE > p_packet_len, "Input packet is truncated.");
+
+		const uint32_t input_id = decode_uint32(&p_packet[offset]);
+		const uint8_t frames_count = p_packet[offset + 4];
+		const int size = decode_uint16(&p_packet[offset + 5]);
+		offset += INPUT_SECTION_HEADER_SIZE;
+
+		ERR_FAIL_COND_MSG(offset + size > p_packet_len, "Input packet is truncated.");
+		ERR_FAIL_COND_MSG(frames_count == 0, "Input packet contains zero frames.");
+		ERR_FAIL_COND_MSG(frames_count > INPUT_FRAMES_MAX, "Input packet contains too many frames.");
+
+		// a peer rarely owns more than a handful of inputs
+		for (const uint32_t index : *owned) {
+			if (inputs[index].input_id == input_id) {
+				InputState &state = inputs[index];
+				const uint64_t previous = state.last_aknownedged_input_id;
+				_process_input_section(p_from, state, frames_count, &p_packet[offset], size);
+
+				// ticks left before the newest frame gets replayed, nothing to measure until replay starts
+				const uint64_t replayed = state.input->get_last_replayed_frame();
+				if (state.last_aknownedged_input_id > previous && replayed > 0) {
+					const int64_t section_lead = int64_t(state.last_aknownedged_input_id - replayed);
+					if (!has_lead || section_lead > lead) {
+						lead = section_lead;
+						target_depth = state.input->get_target_buffer_depth();
+					}
+					has_lead = true;
+				}
+				break;
+			}
+		}
 
-	Vector<Variant> vars;
-	vars.resize(varc);
+		offset += size; // unknown inputs are skipped, they may not be spawned here yet
+	}
+
+	if (has_lead) {
+		multiplayer->_track_input_lead(p_from, lead, target_depth);
+	}
+}
+
+void InputReplicaInterface::_process_input_section(int p_from, InputState &p_state, int p_frames_count, const uint8_t *p_data, int p_size) {
+	NetworkInput *input = p_state.input;
+	ERR_FAIL_COND_MSG(input->get_schema().is_empty(), "Received input from peer with no configured properties.");
 
-	int consumed = 0;
-	Error err = MultiplayerAPI::decode_and_decompress_variants(vars, p_packet + 2, p_packet_len - 2, consumed);
+	Error err = InputFrameCodec::decode(input->get_schema(), p_frames_count, p_data, p_size, values_cache, frames_cache);
 	ERR_FAIL_COND(err != OK);
-	ERR_FAIL_COND(vars.size() != varc); // should not happen
 
 	// read each frame
-	for (int i = 0; i < frames_count; i++) {
-		const int64_t base_idx = i * (prop_size + 1);
-
-		InputFrame frame;
-		frame.frame_id = uint64_t(vars[base_idx]);
+	for (const InputFrame &frame : frames_cache) {
 		ERR_FAIL_COND_MSG(frame.frame_id == 0, "Received input frame with invalid tick 0.");
 
-		if (input_state->last_aknownedged_input_id >= frame.frame_id) {
+		if (p_state.last_aknownedged_input_id >= frame.frame_id) {
 			continue; // already have this input
 		}
 
-		for (int j = 0; j < prop_size; j++) {
-			const int64_t prop_idx = base_idx + 1 + j;
-			ERR_FAIL_UNSIGNED_INDEX(prop_idx, vars.size());
-			ERR_FAIL_INDEX(j, props.size());
-			frame.properties.insert(props[j], vars[prop_idx]);
+		// the ack stays contiguous: frames within a section are consecutive and the client always starts
+		// from its oldest unacknowledged frame, a gap only shows up when the client ran out of history,
+		// those frames are gone for good and the ack moves past them
+		if (frame.frame_id > p_state.last_aknownedged_input_id + 1 && p_state.last_aknownedged_input_id > 0) {
+			WARN_VERBOSE(vformat("Input frames %d to %d from peer %d are lost.", p_state.last_aknownedged_input_id + 1, frame.frame_id - 1, p_from));
 		}
 
 		input->write_frame(frame);
-		input_state->last_aknownedged_input_id = frame.frame_id;
+		p_state.last_aknownedged_input_id = frame.frame_id;
+	}
+}
+
+void InputReplicaInterface::process_input_ack(int p_from, const uint8_t *p_packet, int p_packet_len) {
+	ERR_FAIL_COND_MSG(p_from != MultiplayerPeer::TARGET_PEER_SERVER, "Input acks should only come from the server.");
+	ERR_FAIL_COND_MSG(p_packet_len < INPUT_ACK_HEADER_SIZE, "Invalid input ack received. Size too small.");
+
+	if (multiplayer->get_rollback_state() != RollbackMultiplayer::ROLLBACK_STATE_CLIENT) {
+		return;
+	}
+
+	multiplayer->_apply_lead_hint(decode_half(&p_packet[16]));
+
+	_track_loss(decode_uint16(&p_packet[18]), decode_uint32(&p_packet[20]));
+
+	const int count = p_packet[24];
+	ERR_FAIL_COND_MSG(p_packet_len < INPUT_ACK_HEADER_SIZE + count * INPUT_ACK_ENTRY_SIZE, "Input ack is truncated.");
+
+	for (int i = 0; i < count; i++) {
+		const uint8_t *entry = &p_packet[INPUT_ACK_HEADER_SIZE + i * INPUT_ACK_ENTRY_SIZE];
+		const uint32_t input_id = decode_uint32(&entry[0]);
+
+		for (InputState &state : inputs) {
+			if (state.local && state.input_id == input_id) {
+				state.last_acked_frame_id = MAX(state.last_acked_frame_id, decode_uint64(&entry[4]));
+				break;
+			}
+		}
+	}
+
+	const uint32_t stamp = decode_uint32(&p_packet[0]);
+	const uint32_t hold_usec = decode_uint32(&p_packet[4]);
+	const double server_time = decode_double(&p_packet[8]);
+
+	// the stamp holds the low 32 bits of the clock, it wraps every ~71 minutes, far above any round trip
+	const uint64_t now = OS::get_singleton()->get_ticks_usec();
+	const uint32_t elapsed = uint32_t(now) - stamp;
+	if (elapsed < hold_usec || elapsed > INPUT_ACK_MAX_AGE_USEC) {
+		return; // stale or bogus echo
 	}
+
+	ClockEstimator::Sample sample;
+	sample.local_sent = (now - elapsed) / 1000000.0;
+	sample.local_received = (now - hold_usec) / 1000000.0;
+	sample.remote = server_time;
+
+	multiplayer->_piggyback_clock_sample(sample);
+}
+
+void InputReplicaInterface::remove_peer(int p_peer) {
+	peer_echoes.erase(p_peer);
 }
 
 Error InputReplicaInterface::_send_raw(const uint8_t *p_buffer, int p_size, int p_peer, bool p_reliable) {
@@ -3,6 +3,7 @@
 #include "network_input.h"
 
 #include "core/object/ref_counted.h"
+#include "core/templates/hash_set.h"
 #include "core/templates/local_vector.h"
 
 class RollbackMultiplayer;
@@ -13,20 +14,92 @@ class InputReplicaInterface : public RefCounted {
 	GDCLASS(InputReplicaInterface, RefCounted);
 
 private:
+	static constexpr int INPUT_FRAMES_MAX = 64;
+
+	// every unacknowledged frame is resent, the loss rate extends that by a few frames
+	// in case the acks themselves get lost
+	static constexpr int REDUNDANCY_MAX = 16;
+	static constexpr double REDUNDANCY_PER_LOSS = 20.0; // 5% loss adds a frame
+	static constexpr uint32_t LOSS_WINDOW = 32; // packets per loss measurement
+	static constexpr double LOSS_SMOOTHING = 0.25;
+
+	// every input of a peer travels in one packet, a section per input
+	static constexpr int INPUT_HEADER_SIZE = 8; // flags, sections count, clock stamp, packet sequence
+	static constexpr int INPUT_SECTION_HEADER_SIZE = 7; // input id, frames count, size
+	static constexpr int INPUT_SECTIONS_MAX = 255;
+
+	static constexpr int INPUT_ACK_HEADER_SIZE = 25; // clock echo, lead hint, packet sequence, packets received, entries count
+	static constexpr int INPUT_ACK_ENTRY_SIZE = 12; // input id, highest contiguous frame received
+	static constexpr uint32_t INPUT_ACK_MAX_AGE_USEC = 10000000; // older echoes are stale
+
+	// a live input, resolved when registered and again by rebuild_inputs when the peer or the role changes
+	// inputs unregister in NetworkInput::_stop, on tree exit and authority change, so the pointer stays valid
 	struct InputState {
+		NetworkInput *input = nullptr;
+		ObjectID oid;
+		uint32_t input_id = 0;
+		int peer = 0; // authority
+		bool local = false; // gathered here, otherwise replayed by the server
+
+		// server side, highest frame received with every frame before it
 		uint64_t last_aknownedged_input_id = 0;
+
+		// client side, highest contiguous frame the server has received
+		uint64_t last_acked_frame_id = 0;
+	};
+
+	// server side, clock stamp of the last input packet of a peer, echoed back on the next network tick
+	struct PeerEcho {
+		uint32_t stamp = 0;
+		uint64_t received_usec = 0;
+		double received_time = 0;
+		bool pending = false;
+
+		// newest packet sequence and packets received so far, the client derives its loss from them
+		uint16_t sequence = 0;
+		uint32_t received = 0;
 	};
 
-	HashMap<ObjectID, InputState> inputs;
+	HashSet<ObjectID> registered; // every input added, tracked or not, rebuild_inputs resolves them again
+	bool server = false; // role of this peer, cached with the records
+	LocalVector<InputState> inputs; // dense, walked every tick
+	HashMap<ObjectID, uint32_t> input_indices;
+	HashMap<int, LocalVector<uint32_t>> peer_inputs; // indices by authority, routes packets in one lookup
+	HashMap<int, PeerEcho> peer_echoes;
+
+	// a script may remove inputs while capture_inputs walks them, the records are cleared
+	// in place and the holes closed once the walk is done, so no input gets skipped
+	bool walking = false;
+	bool removals_pending = false;
+	void _compact_inputs();
+
+	// client side loss rate, packets the server received against packets sent
+	// an ack covers every packet up to its sequence, acks merging several packets do not read as loss
+	uint16_t packet_sequence = 0;
+	uint16_t loss_sequence = 0;
+	uint32_t loss_received = 0;
+	bool loss_started = false;
+	double loss = 0;
+	int _get_redundancy() const;
+	void _track_loss(uint16_t p_sequence, uint32_t p_received);
 
 	RollbackMultiplayer *multiplayer = nullptr;
 
-	Error _send_local_inputs();
+	Error _send_input_acks();
+	void _process_input_section(int p_from, InputState &p_state, int p_frames_count, const uint8_t *p_data, int p_size);
 
-	Vector<uint8_t> packet_cache;
-	Error _send_raw(const uint8_t *p_buffer, int p_size, int p_peer, bool p_reliable);
+	// per-tick scratch, cleared but never shrunk, the steady state send path does not allocate
+	LocalVector<uint8_t> packet_cache;
+	LocalVector<InputFrame> frames_cache; // views, into the ring of an input or into values_cache
+	LocalVector<Variant> values_cache; // decoded rows
 
 	void _input_ready(const ObjectID &p_oid);
+	void _input_removed(const ObjectID &p_oid);
+
+protected:
+	Error _send_local_inputs();
+	// Hands a packet to the multiplayer peer, the send path tests stub it out.
+	virtual Error _send_raw(const uint8_t *p_buffer, int p_size, int p_peer, bool p_reliable);
 
 public:
 	Error add_input(Object *p_obj, Variant p_config);
@@ -35,6 +108,12 @@ public:
 	void capture_inputs();
 	void release_inputs();
 	void process_inputs(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void process_input_ack(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void remove_peer(int p_peer);
+	// Resolves every record again, call it when the multiplayer peer or the rollback state changes.
+	void rebuild_inputs();
+	// Fills r_inputs with the inputs packets from p_peer are routed to.
+	void get_peer_inputs(int p_peer, LocalVector<NetworkInput *> &r_inputs) const;
 
 	InputReplicaInterface(RollbackMultiplayer *p_multiplayer) {
 		multiplayer = p_multiplayer;
@@ -0,0 +1,428 @@
+#include "input_schema.h"
+
+#include "core/io/marshalls.h"
+#include "core/math/math_funcs.h"
+
+static _FORCE_INLINE_ uint32_t _float_bits(float p_value) {
+	MarshallFloat mf;
+	mf.f = p_value;
+	return mf.i;
+}
+
+static _FORCE_INLINE_ float _bits_float(uint32_t p_bits) {
+	MarshallFloat mf;
+	mf.i = p_bits;
+	return mf.f;
+}
+
+static _FORCE_INLINE_ uint64_t _double_bits(double p_value) {
+	MarshallDouble md;
+	md.d = p_value;
+	return md.l;
+}
+
+static _FORCE_INLINE_ double _bits_double(uint64_t p_bits) {
+	MarshallDouble md;
+	md.l = p_bits;
+	return md.d;
+}
+
+static _FORCE_INLINE_ uint64_t _zigzag_encode(int64_t p_value) {
+	return (uint64_t(p_value) << 1) ^ uint64_t(p_value >> 63);
+}
+
+static _FORCE_INLINE_ int64_t _zigzag_decode(uint64_t p_value) {
+	return int64_t(p_value >> 1) ^ -int64_t(p_value & 1);
+}
+
+void InputBitWriter::write_bits(uint64_t p_value, int p_bits) {
+	DEV_ASSERT(p_bits >= 0 && p_bits <= 64);
+
+	const uint32_t needed = uint32_t((position + p_bits + 7) / 8);
+	if (buffer.size() < needed) {
+		const uint32_t from = buffer.size();
+		buffer.resize(needed);
+		memset(buffer.ptr() + from, 0, needed - from);
+	}
+
+	while (p_bits > 0) {
+		const int shift = position & 7;
+		const int take = MIN(8 - shift, p_bits);
+		buffer[position >> 3] |= uint8_t((p_value & ((1u << take) - 1)) << shift);
+		p_value >>= take;
+		position += take;
+		p_bits -= take;
+	}
+}
+
+void InputBitWriter::write_varint(uint64_t p_value) {
+	do {
+		const uint64_t group = p_value & 0x7F;
+		p_value >>= 7;
+		write_bits(group | (p_value ? 0x80 : 0), 8);
+	} while (p_value);
+}
+
+uint8_t *InputBitWriter::write_aligned_bytes(int p_size) {
+	DEV_ASSERT(p_size >= 0);
+
+	position = (position + 7) & ~uint64_t(7);
+	const uint32_t from = uint32_t(position / 8);
+	buffer.resize(from + p_size); // the capacity is kept, the steady state does not allocate
+	position += uint64_t(p_size) * 8;
+	return buffer.ptr() + from;
+}
+
+uint64_t InputBitReader::read_bits(int p_bits) {
+	DEV_ASSERT(p_bits >= 0 && p_bits <= 64);
+
+	if (overflow || position + p_bits > size) {
+		overflow = true;
+		return 0;
+	}
+
+	uint64_t value = 0;
+	int written = 0;
+	while (written < p_bits) {
+		const int shift = position & 7;
+		const int take = MIN(8 - shift, p_bits - written);
+		const uint64_t bits = (buffer[position >> 3] >> shift) & ((1u << take) - 1);
+		value |= bits << written;
+		position += take;
+		written += take;
+	}
+	return value;
+}
+
+uint64_t InputBitReader::read_varint() {
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		const uint64_t group = read_bits(8);
+		value |= (group & 0x7F) << shift;
+		if (!(group & 0x80)) {
+			return value;
+		}
+	}
+	overflow = true; // malformed
+	return 0;
+}
+
+const uint8_t *InputBitReader::read_aligned_bytes(int p_size) {
+	position = (position + 7) & ~uint64_t(7);
+	if (overflow || p_size < 0 || position + uint64_t(p_size) * 8 > size) {
+		overflow = true;
+		return nullptr;
+	}
+
+	const uint8_t *data = buffer + position / 8;
+	position += uint64_t(p_size) * 8;
+	return data;
+}
+
+uint64_t InputSchema::Slot::quantize(double p_value) const {
+	const double t = (CLAMP(p_value, range_min, range_max) - range_min) / (range_max - range_min);
+	return uint64_t(Math::round(t * get_steps()));
+}
+
+double InputSchema::Slot::dequantize(uint64_t p_value) const {
+	const uint64_t steps = get_steps();
+	return range_min + (range_max - range_min) * (double(MIN(p_value, steps)) / double(steps));
+}
+
+Error InputSchema::compile(const Ref<NetworkInputReplicaConfig> &p_config, const Object *p_source) {
+	slots.clear();
+	ERR_FAIL_COND_V(p_config.is_null() || !p_source, ERR_INVALID_PARAMETER);
+
+	const Vector<NodePath> props = p_config->get_replica_properties();
+	ERR_FAIL_COND_V_MSG(props.size() > MAX_SLOTS, ERR_INVALID_PARAMETER, vformat("Input replica config exceeds %d properties.", MAX_SLOTS));
+
+	// declared types, the current value may still be null, or an int in a float property
+	HashMap<StringName, Variant::Type> declared;
+	List<PropertyInfo> plist;
+	p_source->get_property_list(&plist);
+	for (const PropertyInfo &pi : plist) {
+		declared[pi.name] = pi.type;
+	}
+
+	for (const NodePath &prop : props) {
+		bool valid = false;
+		const Variant value = p_source->get_indexed(prop.get_names(), &valid);
+		if (!valid) {
+			slots.clear(); // never leave a partial layout, the other end would read it differently
+			ERR_FAIL_V_MSG(ERR_DOES_NOT_EXIST, vformat("Property '%s' not found.", prop));
+		}
+
+		Slot slot;
+		slot.path = prop;
+		slot.type = value.get_type();
+
+		// only direct properties are declared, nested paths keep the type of their value
+		const Variant::Type *type = prop.get_name_count() == 1 ? declared.getptr(prop.get_name(0)) : nullptr;
+		if (type && *type != Variant::NIL) {
+			slot.type = *type;
+		}
+
+		// caught here once, gather would fail on every tick otherwise
+		switch (slot.type) {
+			case Variant::NIL: {
+				slots.clear();
+				ERR_FAIL_V_MSG(ERR_INVALID_DATA, vformat("Property '%s' has no type, declare its type or give it a value before the input enters the tree.", prop));
+			} break;
+			case Variant::OBJECT:
+			case Variant::RID:
+			case Variant::CALLABLE:
+			case Variant::SIGNAL: {
+				slots.clear();
+				ERR_FAIL_V_MSG(ERR_INVALID_DATA, vformat("Property '%s' is of type %s, which cannot be replicated as input.", prop, Variant::get_type_name(slot.type)));
+			} break;
+			default:
+				break;
+		}
+		slot.precision = p_config->property_get_precision(prop);
+		slot.quantization_bits = p_config->property_get_quantization_bits(prop);
+		slot.range_min = p_config->property_get_range_min(prop);
+		slot.range_max = p_config->property_get_range_max(prop);
+		slot.deadzone = p_config->property_get_deadzone(prop);
+		if (slot.range_max <= slot.range_min) {
+			slot.quantization_bits = 0; // invalid range, send as is
+		}
+		slots.push_back(slot);
+	}
+
+	return OK;
+}
+
+void InputSchema::_write_real(InputBitWriter &p_writer, const Slot &p_slot, double p_value, bool p_real_t) const {
+	if (p_slot.quantization_bits > 0) {
+		p_writer.write_bits(p_slot.quantize(p_value), p_slot.quantization_bits);
+		return;
+	}
+
+	switch (p_slot.precision) {
+		case NetworkInputReplicaConfig::PRECISION_HALF: {
+			p_writer.write_bits(Math::make_half_float(float(p_value)), 16);
+		} break;
+		case NetworkInputReplicaConfig::PRECISION_SINGLE: {
+			p_writer.write_bits(_float_bits(float(p_value)), 32);
+		} break;
+		default: {
+			if (p_real_t && sizeof(real_t) == 4) {
+				p_writer.write_bits(_float_bits(float(p_value)), 32);
+			} else {
+				p_writer.write_bits(_double_bits(p_value), 64);
+			}
+		} break;
+	}
+}
+
+double InputSchema::_read_real(InputBitReader &p_reader, const Slot &p_slot, bool p_real_t) const {
+	if (p_slot.quantization_bits > 0) {
+		return p_slot.dequantize(p_reader.read_bits(p_slot.quantization_bits));
+	}
+
+	switch (p_slot.precision) {
+		case NetworkInputReplicaConfig::PRECISION_HALF: {
+			return Math::half_to_float(uint16_t(p_reader.read_bits(16)));
+		}
+		case NetworkInputReplicaConfig::PRECISION_SINGLE: {
+			return _bits_float(uint32_t(p_reader.read_bits(32)));
+		}
+		default: {
+			if (p_real_t && sizeof(real_t) == 4) {
+				return _bits_float(uint32_t(p_reader.read_bits(32)));
+			}
+			return _bits_double(p_reader.read_bits(64));
+		}
+	}
+}
+
+double InputSchema::_snap_real(const Slot &p_slot, double p_value) const {
+	if (p_slot.quantization_bits > 0) {
+		return p_slot.dequantize(p_slot.quantize(p_value));
+	}
+
+	switch (p_slot.precision) {
+		case NetworkInputReplicaConfig::PRECISION_HALF:
+			return Math::half_to_float(Math::make_half_float(float(p_value)));
+		case NetworkInputReplicaConfig::PRECISION_SINGLE:
+			return float(p_value);
+		default:
+			return p_value;
+	}
+}
+
+void InputSchema::snap(int p_slot, Variant &r_value) const {
+	const Slot &slot = slots[p_slot];
+	if (slot.precision == NetworkInputReplicaConfig::PRECISION_FULL && slot.quantization_bits == 0 && slot.deadzone <= 0.0) {
+		return;
+	}
+
+	// the deadzone is radial for vectors
+	switch (r_value.get_type()) {
+		case Variant::FLOAT: {
+			double v = r_value;
+			if (Math::abs(v) < slot.deadzone) {
+				v = 0.0;
+			}
+			r_value = _snap_real(slot, v);
+		} break;
+		case Variant::VECTOR2: {
+			Vector2 v = r_value;
+			if (v.length() < slot.deadzone) {
+				v = Vector2();
+			}
+			r_value = Vector2(_snap_real(slot, v.x), _snap_real(slot, v.y));
+		} break;
+		case Variant::VECTOR3: {
+			Vector3 v = r_value;
+			if (v.length() < slot.deadzone) {
+				v = Vector3();
+			}
+			r_value = Vector3(_snap_real(slot, v.x), _snap_real(slot, v.y), _snap_real(slot, v.z));
+		} break;
+		case Variant::VECTOR4: {
+			Vector4 v = r_value;
+			if (v.length() < slot.deadzone) {
+				v = Vector4();
+			}
+			r_value = Vector4(_snap_real(slot, v.x), _snap_real(slot, v.y), _snap_real(slot, v.z), _snap_real(slot, v.w));
+		} break;
+		default:
+			break;
+	}
+}
+
+Error InputSchema::write(InputBitWriter &p_writer, int p_slot, const Variant &p_value) const {
+	const Slot &slot = slots[p_slot];
+	ERR_FAIL_COND_V_MSG(p_value.get_type() != slot.type, ERR_INVALID_DATA, vformat("Property '%s' changed type since the schema was compiled.", slot.path));
+
+	switch (slot.type) {
+		case Variant::NIL: {
+		} break;
+		case Variant::BOOL: {
+			p_writer.write_bool(p_value.operator bool());
+		} break;
+		case Variant::INT: {
+			p_writer.write_varint(_zigzag_encode(p_value.operator int64_t()));
+		} break;
+		case Variant::FLOAT: {
+			_write_real(p_writer, slot, p_value.operator double(), false);
+		} break;
+		case Variant::VECTOR2: {
+			const Vector2 v = p_value;
+			_write_real(p_writer, slot, v.x, true);
+			_write_real(p_writer, slot, v.y, true);
+		} break;
+		case Variant::VECTOR3: {
+			const Vector3 v = p_value;
+			_write_real(p_writer, slot, v.x, true);
+			_write_real(p_writer, slot, v.y, true);
+			_write_real(p_writer, slot, v.z, true);
+		} break;
+		case Variant::VECTOR4: {
+			const Vector4 v = p_value;
+			_write_real(p_writer, slot, v.x, true);
+			_write_real(p_writer, slot, v.y, true);
+			_write_real(p_writer, slot, v.z, true);
+			_write_real(p_writer, slot, v.w, true);
+		} break;
+		case Variant::VECTOR2I: {
+			const Vector2i v = p_value;
+			p_writer.write_varint(_zigzag_encode(v.x));
+			p_writer.write_varint(_zigzag_encode(v.y));
+		} break;
+		case Variant::VECTOR3I: {
+			const Vector3i v = p_value;
+			p_writer.write_varint(_zigzag_encode(v.x));
+			p_writer.write_varint(_zigzag_encode(v.y));
+			p_writer.write_varint(_zigzag_encode(v.z));
+		} break;
+		case Variant::VECTOR4I: {
+			const Vector4i v = p_value;
+			p_writer.write_varint(_zigzag_encode(v.x));
+			p_writer.write_varint(_zigzag_encode(v.y));
+			p_writer.write_varint(_zigzag_encode(v.z));
+			p_writer.write_varint(_zigzag_encode(v.w));
+		} break;
+		default: {
+			// anything else goes through the generic encoder, length prefixed, byte aligned and written in place
+			int len;
+			Error err = encode_variant(p_value, nullptr, len, false);
+			ERR_FAIL_COND_V(err != OK, err);
+
+			p_writer.write_varint(len);
+			encode_variant(p_value, p_writer.write_aligned_bytes(len), len, false);
+		} break;
+	}
+
+	return OK;
+}
+
+Error InputSchema::read(InputBitReader &p_reader, int p_slot, Variant &r_value) const {
+	const Slot &slot = slots[p_slot];
+
+	switch (slot.type) {
+		case Variant::NIL: {
+			r_value = Variant();
+		} break;
+		case Variant::BOOL: {
+			r_value = p_reader.read_bool();
+		} break;
+		case Variant::INT: {
+			r_value = _zigzag_decode(p_reader.read_varint());
+		} break;
+		case Variant::FLOAT: {
+			r_value = _read_real(p_reader, slot, false);
+		} break;
+		case Variant::VECTOR2: {
+			const real_t x = _read_real(p_reader, slot, true);
+			const real_t y = _read_real(p_reader, slot, true);
+			r_value = Vector2(x, y);
+		} break;
+		case Variant::VECTOR3: {
+			const real_t x = _read_real(p_reader, slot, true);
+			const real_t y = _read_real(p_reader, slot, true);
+			const real_t z = _read_real(p_reader, slot, true);
+			r_value = Vector3(x, y, z);
+		} break;
+		case Variant::VECTOR4: {
+			const real_t x = _read_real(p_reader, slot, true);
+			const real_t y = _read_real(p_reader, slot, true);
+			const real_t z = _read_real(p_reader, slot, true);
+			const real_t w = _read_real(p_reader, slot, true);
+			r_value = Vector4(x, y, z, w);
+		} break;
+		case Variant::VECTOR2I: {
+			const int32_t x = int32_t(_zigzag_decode(p_reader.read_varint()));
+			const int32_t y = int32_t(_zigzag_decode(p_reader.read_varint()));
+			r_value = Vector2i(x, y);
+		} break;
+		case Variant::VECTOR3I: {
+			const int32_t x = int32_t(_zigzag_decode(p_reader.read_varint()));
+			const int32_t y = int32_t(_zigzag_decode(p_reader.read_varint()));
+			const int32_t z = int32_t(_zigzag_decode(p_reader.read_varint()));
+			r_value = Vector3i(x, y, z);
+		} break;
+		case Variant::VECTOR4I: {
+			const int32_t x = int32_t(_zigzag_decode(p_reader.read_varint()));
+			const int32_t y = int32_t(_zigzag_decode(p_reader.read_varint()));
+			const int32_t z = int32_t(_zigzag_decode(p_reader.read_varint()));
+			const int32_t w = int32_t(_zigzag_decode(p_reader.read_varint()));
+			r_value = Vector4i(x, y, z, w);
+		} break;
+		default: {
+			const uint64_t len = p_reader.read_varint();
+			ERR_FAIL_COND_V(p_reader.has_overflowed() || len > uint64_t(p_reader.get_remaining_bytes()), ERR_INVALID_DATA);
+
+			const uint8_t *data = p_reader.read_aligned_bytes(len);
+			ERR_FAIL_NULL_V(data, ERR_INVALID_DATA);
+
+			Error err = decode_variant(r_value, data, len, nullptr, false);
+			ERR_FAIL_COND_V(err != OK, err);
+			ERR_FAIL_COND_V(r_value.get_type() != slot.type, ERR_INVALID_DATA);
+		} break;
+	}
+
+	ERR_FAIL_COND_V(p_reader.has_overflowed(), ERR_INVALID_DATA);
+	return OK;
+}
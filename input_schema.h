@@ -0,0 +1,104 @@
+#pragma once
+
+#include "network_input_replica_config.h"
+
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+class InputBitWriter {
+	LocalVector<uint8_t> &buffer;
+	uint64_t position = 0; // in bits
+
+public:
+	void write_bits(uint64_t p_value, int p_bits);
+	void write_bool(bool p_value) { write_bits(p_value ? 1 : 0, 1); }
+	void write_varint(uint64_t p_value);
+	// Pads to the next byte and reserves p_size bytes, returns where to write them, valid until the next write.
+	uint8_t *write_aligned_bytes(int p_size);
+
+	int get_size() const { return int((position + 7) / 8); }
+
+	// Appends at p_offset, anything past it is discarded, the capacity is kept.
+	InputBitWriter(LocalVector<uint8_t> &r_buffer, uint32_t p_offset = 0) :
+			buffer(r_buffer), position(uint64_t(p_offset) * 8) {
+		buffer.resize(p_offset);
+	}
+};
+
+class InputBitReader {
+	const uint8_t *buffer = nullptr;
+	uint64_t size = 0; // in bits
+	uint64_t position = 0;
+	bool overflow = false;
+
+public:
+	uint64_t read_bits(int p_bits);
+	bool read_bool() { return read_bits(1) != 0; }
+	uint64_t read_varint();
+	// Skips to the next byte and returns the next p_size bytes in place, nullptr past the end.
+	const uint8_t *read_aligned_bytes(int p_size);
+
+	// reads past the end return zeros and set this flag
+	bool has_overflowed() const { return overflow; }
+	int get_remaining_bytes() const { return overflow ? 0 : int((size - position) / 8); }
+
+	InputBitReader(const uint8_t *p_buffer, int p_size) {
+		buffer = p_buffer;
+		size = uint64_t(p_size) * 8;
+	}
+};
+
+/**
+ * Wire layout of a NetworkInputReplicaConfig, compiled once per input.
+ *
+ * The property set and the value types are fixed and known on both ends, so
+ * values are written without type tags: bools are a single bit, integers are
+ * zigzag varints, floats and vectors are packed at the precision configured
+ * for the property, or as fixed-point when quantization is set. Other types
+ * fall back to the generic Variant encoder.
+ *
+ * The deadzone and the quantization are lossy, snap() applies them on the
+ * sending side too so both ends simulate with bit-identical inputs.
+ */
+class InputSchema {
+public:
+	struct Slot {
+		NodePath path;
+		Variant::Type type = Variant::NIL;
+		NetworkInputReplicaConfig::PropertyPrecision precision = NetworkInputReplicaConfig::PRECISION_FULL;
+
+		int quantization_bits = 0;
+		double range_min = -1.0;
+		double range_max = 1.0;
+		double deadzone = 0.0;
+
+		// an even number of steps, so the center of a symmetric range is exact
+		uint64_t get_steps() const { return quantization_bits > 1 ? (uint64_t(1) << quantization_bits) - 2 : 1; }
+		uint64_t quantize(double p_value) const;
+		double dequantize(uint64_t p_value) const;
+	};
+
+	static constexpr int MAX_SLOTS = 64;
+
+private:
+	LocalVector<Slot> slots;
+
+	void _write_real(InputBitWriter &p_writer, const Slot &p_slot, double p_value, bool p_real_t) const;
+	double _read_real(InputBitReader &p_reader, const Slot &p_slot, bool p_real_t) const;
+	double _snap_real(const Slot &p_slot, double p_value) const;
+
+public:
+	// Reads the value types from p_source, the node owning the properties.
+	Error compile(const Ref<NetworkInputReplicaConfig> &p_config, const Object *p_source);
+	void clear() { slots.clear(); }
+
+	bool is_empty() const { return slots.is_empty(); }
+	int size() const { return slots.size(); }
+	const Slot &get_slot(int p_slot) const { return slots[p_slot]; }
+
+	// Rounds the value to what the other end will decode.
+	void snap(int p_slot, Variant &r_value) const;
+
+	Error write(InputBitWriter &p_writer, int p_slot, const Variant &p_value) const;
+	Error read(InputBitReader &p_reader, int p_slot, Variant &r_value) const;
+};
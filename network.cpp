@@ -3,6 +3,7 @@
 
 void ReferenceClock::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_time"), &ReferenceClock::get_time);
+	ClassDB::bind_method(D_METHOD("get_precise_time"), &ReferenceClock::get_precise_time);
 	ClassDB::bind_method(D_METHOD("get_reference_frames"), &ReferenceClock::get_reference_frames);
 }
 
@@ -16,6 +17,27 @@ Network *Network::get_singleton() {
 	return singleton;
 }
 
+int64_t Network::add_timer(double p_wait_time, const Callable &p_callback, bool p_repeat) {
+	return timer_wheel.add(FrameTime::get_ticks_usec(), p_wait_time, p_callback, p_repeat);
+}
+
+void Network::remove_timer(int64_t p_timer_id) {
+	timer_wheel.remove(p_timer_id);
+}
+
+void Network::set_network_ticks_per_second(int p_ticks_per_second) {
+	ERR_FAIL_COND_MSG(p_ticks_per_second <= 0, "Network ticks per second must be greater than 0.");
+	network_ticks_per_second = p_ticks_per_second;
+}
+
+int Network::get_frames_per_network_tick() const {
+	const int physics_ticks_per_second = Engine::get_singleton()->get_physics_ticks_per_second();
+	if (network_ticks_per_second >= physics_ticks_per_second) {
+		return 1;
+	}
+	return (physics_ticks_per_second + network_ticks_per_second - 1) / network_ticks_per_second;
+}
+
 void Network::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_in_rollback_frame"), &Network::is_in_rollback_frame);
 	ClassDB::bind_method(D_METHOD("get_network_frames"), &Network::get_network_frames);
@@ -25,8 +47,18 @@ void Network::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_steps_count"), &Network::get_steps_count);
 
+	ClassDB::bind_method(D_METHOD("set_network_ticks_per_second", "ticks_per_second"), &Network::set_network_ticks_per_second);
+	ClassDB::bind_method(D_METHOD("get_network_ticks_per_second"), &Network::get_network_ticks_per_second);
+	ClassDB::bind_method(D_METHOD("is_network_tick"), &Network::is_network_tick);
+	ClassDB::bind_method(D_METHOD("get_frames_per_network_tick"), &Network::get_frames_per_network_tick);
+	ClassDB::bind_method(D_METHOD("get_input_lead"), &Network::get_input_lead);
+
+	ClassDB::bind_method(D_METHOD("add_timer", "wait_time", "callback", "repeat"), &Network::add_timer, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("remove_timer", "timer_id"), &Network::remove_timer);
+
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "reference_clock"), "", "get_reference_clock");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "simulation_clock"), "", "get_simulation_clock");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "network_ticks_per_second", PROPERTY_HINT_RANGE, "1,1000,1"), "set_network_ticks_per_second", "get_network_ticks_per_second");
 }
 
 Network::Network() {
@@ -36,7 +68,7 @@ Network::Network() {
 	_reference_clock_ptr = memnew(ReferenceClock);
 	_simulation_clock_ptr = memnew(SimulationClock);
 
-	GLOBAL_DEF_BASIC(PropertyInfo(Variant::INT, "multiplayer/common/network_ticks_per_second", PROPERTY_HINT_RANGE, "1,1000,1"), 60);
+	network_ticks_per_second = GLOBAL_DEF_BASIC(PropertyInfo(Variant::INT, "multiplayer/common/network_ticks_per_second", PROPERTY_HINT_RANGE, "1,1000,1"), 60);
 }
 
 Network::~Network() {
@@ -1,13 +1,22 @@
 #pragma once
 
+#include "timer_wheel.h"
+#include "tinystuff.h"
+
 #include "core/config/engine.h"
 #include "core/object/class_db.h"
 #include "core/os/os.h"
 
+// Precise reading, only for packet timestamps, see get_frame_time().
 static double get_wall_time() {
 	return OS::get_singleton()->get_ticks_usec() / 1000000.0;
 }
 
+// Wall time sampled at the start of the current step, see FrameTime.
+static double get_frame_time() {
+	return FrameTime::get_time();
+}
+
 // about network time:
 // clocks are in fraction seconds (double) instead of uint64_t
 // fraction seconds are easier to work with, they maintain solid precision for a very long time
@@ -27,10 +36,14 @@ protected:
 
 public:
 	double get_time() const {
+		return get_frame_time() + offset;
+	}
+	double get_precise_time() const {
 		return get_wall_time() + offset;
 	}
+	// against the frame time, get_time() reads p_time back for the rest of the step
 	void set_time(double p_time) {
-		offset = p_time - get_wall_time();
+		offset = p_time - get_frame_time();
 	}
 	void set_offset(double p_offset) {
 		offset = p_offset;
@@ -66,7 +79,7 @@ public:
 		return time;
 	}
 	void set_time(double p_time) {
-		last_time = get_wall_time();
+		last_time = get_frame_time();
 		time = p_time;
 		accumulator = p_time;
 	}
@@ -84,7 +97,7 @@ public:
 	}
 
 	void step() {
-		const double current_step = get_wall_time();
+		const double current_step = get_frame_time();
 		const double step_duration = current_step - last_time;
 		last_time = current_step;
 		adjust(step_duration * time_scale);
@@ -133,11 +146,13 @@ private:
 	ReferenceClock *_reference_clock_ptr = nullptr;
 	SimulationClock *_simulation_clock_ptr = nullptr;
 
+	TimerWheel timer_wheel; // shared scheduler for periodic network jobs
+
 	void reset_time() {
 		// _reference_clock_ptr->set_time(0);
 		// _simulation_clock_ptr->set_time(Network::get_singleton()->_reference_clock_ptr->get_time());
 
-		const double n = get_wall_time();
+		const double n = get_frame_time();
 		_reference_clock_ptr->offset = -n;
 		_simulation_clock_ptr->last_time = n;
 		_simulation_clock_ptr->time = 0.0;
@@ -148,10 +163,30 @@ private:
 		_simulation_clock_ptr->steps = 0;
 
 		_network_frames = 0;
+		_network_tick = true;
+		_input_lead = 0;
 	}
 
 	bool _in_rollback = false; // if the current frame is a rollback frame
 	uint64_t _network_frames = 0; // frame elapsed since start, increments by 1 each physics frame
+	double _input_lead = 0; // seconds the client simulation runs ahead of the reference clock, driven by the server
+
+	// network traffic runs on its own schedule, derived from the physics frame count
+	// so both peers agree on which frames send, frames in between are batched
+	int network_ticks_per_second = 60;
+	bool _network_tick = true; // if the current physics frame is also a network tick
+
+	void _update_network_tick() {
+		const uint64_t physics_ticks_per_second = Engine::get_singleton()->get_physics_ticks_per_second();
+		if (uint64_t(network_ticks_per_second) >= physics_ticks_per_second || _network_frames == 0) {
+			_network_tick = true;
+			return;
+		}
+
+		const uint64_t ticks = _network_frames * network_ticks_per_second / physics_ticks_per_second;
+		const uint64_t last_ticks = (_network_frames - 1) * network_ticks_per_second / physics_ticks_per_second;
+		_network_tick = ticks != last_ticks;
+	}
 
 protected:
 	static void _bind_methods();
@@ -164,6 +199,16 @@ public:
 
 	bool is_in_rollback_frame() const { return _in_rollback; }
 
+	void set_network_ticks_per_second(int p_ticks_per_second);
+	int get_network_ticks_per_second() const { return network_ticks_per_second; }
+	bool is_network_tick() const { return _network_tick; }
+	double get_input_lead() const { return _input_lead; }
+	int get_frames_per_network_tick() const;
+
+	TimerWheel &get_timer_wheel() { return timer_wheel; }
+	int64_t add_timer(double p_wait_time, const Callable &p_callback, bool p_repeat = true);
+	void remove_timer(int64_t p_timer_id);
+
 	// Current network time in frames.
 	uint64_t get_network_frames() const { return _network_frames; } // TODO: rename, network frames have nothing to do with game ticks
 	uint64_t get_simulation_frames() const { return _network_frames; }
@@ -1,21 +1,141 @@
 #include "network_input.h"
 #include "network.h"
 
-Error NetworkInput::copy_buffer(Vector<InputFrame> &frames, int p_count) {
-	ERR_FAIL_COND_V(p_count < -1, ERR_INVALID_PARAMETER);
+#include "core/object/script_instance.h"
 
-	p_count = p_count == -1 ? buffer.data_left() : MIN(p_count, buffer.data_left());
+int NetworkInput::get_buffered_frames(int p_count, LocalVector<InputFrame> &r_frames) const {
+	r_frames.clear(); // keeps its capacity
+	ERR_FAIL_COND_V(p_count < -1, 0);
 
-	frames.resize(p_count);
-	if (p_count > 0) {
-		int copied = buffer.copy(frames.ptrw(), buffer.data_left() - p_count, p_count);
-		ERR_FAIL_COND_V(copied != p_count, ERR_BUG);
+	p_count = p_count == -1 ? buffer.size() : MIN(p_count, buffer.size());
+	for (int i = buffer.size() - p_count; i < buffer.size(); i++) {
+		r_frames.push_back(_get_frame(i));
 	}
-	return OK;
+	return p_count;
 }
 
 void NetworkInput::set_replica_config(Ref<NetworkInputReplicaConfig> p_config) {
 	replica_config = p_config;
+
+	if (is_inside_tree()) {
+		_compile_schema();
+	} else {
+		schema.clear();
+		accessors.clear();
+	}
+}
+
+void NetworkInput::_compile_schema() {
+	schema.clear();
+	accessors.clear();
+	slot_samples.clear();
+	slot_indices.clear();
+	if (replica_config.is_null()) {
+		return;
+	}
+
+	Error err = schema.compile(replica_config, this);
+	if (err != OK) {
+		schema.clear(); // nothing gets replicated rather than a layout the other end disagrees with
+		ERR_FAIL_MSG(vformat("Unable to compile the input replica config of '%s'.", get_path()));
+	}
+
+	// the rows take the new layout, frames of the old one are meaningless
+	buffer.clear();
+	buffer_values.resize(buffer.capacity() * schema.size());
+	gather_row.resize(schema.size());
+	last_replayed_values.resize(schema.size());
+	last_replayed_frame_id = 0;
+
+	ScriptInstance *script = get_script_instance();
+
+	accessors.resize(schema.size());
+	slot_samples.resize(schema.size());
+	for (int i = 0; i < schema.size(); i++) {
+		slot_indices.insert(schema.get_slot(i).path, i);
+
+		PropertyAccessor &accessor = accessors[i];
+		accessor.names = schema.get_slot(i).path.get_names();
+		if (accessor.names.size() != 1) {
+			continue; // nested, generic path
+		}
+		accessor.name = accessor.names[0];
+
+		// script members first, the same order Object::get uses
+		Variant value;
+		if (script && script->get(accessor.name, value)) {
+			accessor.mode = PropertyAccessor::ACCESS_SCRIPT;
+			continue;
+		}
+
+		const StringName getter = ClassDB::get_property_getter(get_class_name(), accessor.name);
+		const StringName setter = ClassDB::get_property_setter(get_class_name(), accessor.name);
+		accessor.getter = getter == StringName() ? nullptr : ClassDB::get_method(get_class_name(), getter);
+		accessor.setter = setter == StringName() ? nullptr : ClassDB::get_method(get_class_name(), setter);
+		if (accessor.getter && accessor.setter) {
+			accessor.index = ClassDB::get_property_index(get_class_name(), accessor.name);
+			accessor.mode = PropertyAccessor::ACCESS_NATIVE;
+		}
+	}
+}
+
+Variant NetworkInput::_get_property(const PropertyAccessor &p_accessor, bool *r_valid) {
+	switch (p_accessor.mode) {
+		case PropertyAccessor::ACCESS_SCRIPT: {
+			Variant ret;
+			ScriptInstance *script = get_script_instance();
+			if (script && script->get(p_accessor.name, ret)) {
+				*r_valid = true;
+				return ret;
+			}
+		} break;
+
+		case PropertyAccessor::ACCESS_NATIVE: {
+			Callable::CallError ce;
+			const Variant index = p_accessor.index;
+			const Variant *args[1] = { &index };
+			Variant ret = p_accessor.getter->call(this, args, p_accessor.index >= 0 ? 1 : 0, ce);
+			if (ce.error == Callable::CallError::CALL_OK) {
+				*r_valid = true;
+				return ret;
+			}
+		} break;
+
+		default:
+			break;
+	}
+
+	return get_indexed(p_accessor.names, r_valid);
+}
+
+void NetworkInput::_set_property(const PropertyAccessor &p_accessor, const Variant &p_value) {
+	switch (p_accessor.mode) {
+		case PropertyAccessor::ACCESS_SCRIPT: {
+			ScriptInstance *script = get_script_instance();
+			if (script && script->set(p_accessor.name, p_value)) {
+				return;
+			}
+		} break;
+
+		case PropertyAccessor::ACCESS_NATIVE: {
+			Callable::CallError ce;
+			const Variant index = p_accessor.index;
+			const Variant *args[2] = { &index, &p_value };
+			if (p_accessor.index >= 0) {
+				p_accessor.setter->call(this, args, 2, ce);
+			} else {
+				p_accessor.setter->call(this, &args[1], 1, ce);
+			}
+			if (ce.error == Callable::CallError::CALL_OK) {
+				return;
+			}
+		} break;
+
+		default:
+			break;
+	}
+
+	set_indexed(p_accessor.names, p_value);
 }
 
 Ref<NetworkInputReplicaConfig> NetworkInput::get_replica_config() {
@@ -27,12 +147,151 @@ void NetworkInput::set_multiplayer_authority(int p_peer_id, bool p_recursive) {
 		return;
 	}
 
+	// out of the tree the authority is only stored, entering the tree starts the input with it
 	_stop();
 	Node::set_multiplayer_authority(p_peer_id, p_recursive);
 	_start();
 }
 
+void NetworkInput::_accumulate(SlotSample &r_sample, Variant::Type p_type, const Variant &p_value) {
+	switch (p_type) {
+		case Variant::BOOL: {
+			r_sample.pressed = r_sample.pressed || p_value.operator bool();
+		} break;
+		case Variant::INT: {
+			r_sample.integer[0] += p_value.operator int64_t();
+		} break;
+		case Variant::FLOAT: {
+			r_sample.real[0] += p_value.operator double();
+		} break;
+		case Variant::VECTOR2: {
+			const Vector2 v = p_value;
+			r_sample.real[0] += v.x;
+			r_sample.real[1] += v.y;
+		} break;
+		case Variant::VECTOR3: {
+			const Vector3 v = p_value;
+			r_sample.real[0] += v.x;
+			r_sample.real[1] += v.y;
+			r_sample.real[2] += v.z;
+		} break;
+		case Variant::VECTOR4: {
+			const Vector4 v = p_value;
+			r_sample.real[0] += v.x;
+			r_sample.real[1] += v.y;
+			r_sample.real[2] += v.z;
+			r_sample.real[3] += v.w;
+		} break;
+		case Variant::VECTOR2I: {
+			const Vector2i v = p_value;
+			r_sample.integer[0] += v.x;
+			r_sample.integer[1] += v.y;
+		} break;
+		case Variant::VECTOR3I: {
+			const Vector3i v = p_value;
+			r_sample.integer[0] += v.x;
+			r_sample.integer[1] += v.y;
+			r_sample.integer[2] += v.z;
+		} break;
+		case Variant::VECTOR4I: {
+			const Vector4i v = p_value;
+			r_sample.integer[0] += v.x;
+			r_sample.integer[1] += v.y;
+			r_sample.integer[2] += v.z;
+			r_sample.integer[3] += v.w;
+		} break;
+		default: {
+			r_sample.latest = p_value;
+		} break;
+	}
+	r_sample.samples++;
+}
+
+Variant NetworkInput::_average(const SlotSample &p_sample, Variant::Type p_type) {
+	const double n = p_sample.samples;
+	const int64_t ni = p_sample.samples;
+
+	switch (p_type) {
+		case Variant::BOOL:
+			return p_sample.pressed;
+		case Variant::INT:
+			return p_sample.integer[0] / ni;
+		case Variant::FLOAT:
+			return p_sample.real[0] / n;
+		case Variant::VECTOR2:
+			return Vector2(p_sample.real[0] / n, p_sample.real[1] / n);
+		case Variant::VECTOR3:
+			return Vector3(p_sample.real[0] / n, p_sample.real[1] / n, p_sample.real[2] / n);
+		case Variant::VECTOR4:
+			return Vector4(p_sample.real[0] / n, p_sample.real[1] / n, p_sample.real[2] / n, p_sample.real[3] / n);
+		case Variant::VECTOR2I:
+			return Vector2i(p_sample.integer[0] / ni, p_sample.integer[1] / ni);
+		case Variant::VECTOR3I:
+			return Vector3i(p_sample.integer[0] / ni, p_sample.integer[1] / ni, p_sample.integer[2] / ni);
+		case Variant::VECTOR4I:
+			return Vector4i(p_sample.integer[0] / ni, p_sample.integer[1] / ni, p_sample.integer[2] / ni, p_sample.integer[3] / ni);
+		default:
+			return p_sample.latest;
+	}
+}
+
+template <typename T>
+void NetworkInput::_sample_array(const NodePath &p_property, const Vector<T> &p_values) {
+	const int *slot = slot_indices.getptr(p_property);
+	if (!slot) {
+		for (const T &value : p_values) {
+			sample(p_property, value); // not replicated, generic path
+		}
+		return;
+	}
+
+	// one lookup for the whole batch, values are wrapped on the stack
+	SlotSample &accumulator = slot_samples[*slot];
+	const Variant::Type type = schema.get_slot(*slot).type;
+	for (const T &value : p_values) {
+		_accumulate(accumulator, type, value);
+	}
+}
+
+void NetworkInput::sample_many(const NodePath &p_property, const Variant &p_values) {
+	switch (p_values.get_type()) {
+		case Variant::PACKED_BYTE_ARRAY: {
+			_sample_array<uint8_t>(p_property, p_values);
+		} break;
+		case Variant::PACKED_INT32_ARRAY: {
+			_sample_array<int32_t>(p_property, p_values);
+		} break;
+		case Variant::PACKED_INT64_ARRAY: {
+			_sample_array<int64_t>(p_property, p_values);
+		} break;
+		case Variant::PACKED_FLOAT32_ARRAY: {
+			_sample_array<float>(p_property, p_values);
+		} break;
+		case Variant::PACKED_FLOAT64_ARRAY: {
+			_sample_array<double>(p_property, p_values);
+		} break;
+		case Variant::PACKED_VECTOR2_ARRAY: {
+			_sample_array<Vector2>(p_property, p_values);
+		} break;
+		case Variant::PACKED_VECTOR3_ARRAY: {
+			_sample_array<Vector3>(p_property, p_values);
+		} break;
+		case Variant::PACKED_VECTOR4_ARRAY: {
+			_sample_array<Vector4>(p_property, p_values);
+		} break;
+		default: {
+			ERR_FAIL_MSG(vformat("Cannot sample '%s', expected a packed array, got %s.", p_property, Variant::get_type_name(p_values.get_type())));
+		} break;
+	}
+}
+
 void NetworkInput::sample(const NodePath &p_property, const Variant &p_value) {
+	const int *slot = slot_indices.getptr(p_property);
+	if (slot) {
+		_accumulate(slot_samples[*slot], schema.get_slot(*slot).type, p_value);
+		return;
+	}
+
 	if (!_samples.has(p_property)) {
 		InputSample sample;
 		sample.accumulated = p_value;
@@ -67,6 +326,15 @@ void NetworkInput::sample(const NodePath &p_property, const Variant &p_value) {
 }
 
 void NetworkInput::gather() {
+	for (uint32_t i = 0; i < slot_samples.size(); i++) {
+		SlotSample &sample = slot_samples[i];
+		if (sample.samples == 0) {
+			continue;
+		}
+		_set_property(accessors[i], _average(sample, schema.get_slot(i).type));
+		sample = SlotSample();
+	}
+
 	for (const KeyValue<NodePath, InputSample> &E : _samples) {
 		const NodePath &prop = E.key;
 		const InputSample &sample = E.value;
@@ -94,17 +362,14 @@ void NetworkInput::gather() {
 
 	GDVIRTUAL_CALL(_gather); // TODO: return if the call have failed?
 
-	if (replica_config.is_null()) {
+	if (replica_config.is_null() || schema.is_empty()) {
 		return; // do not care if there is no config, we just wont replicate anything
 	}
 
-	InputFrame frame;
-	frame.frame_id = _current_frame_id;
-
-	const Vector<NodePath> props = replica_config->get_replica_properties();
-	for (const NodePath &prop : props) {
+	for (int i = 0; i < schema.size(); i++) {
+		const NodePath &prop = schema.get_slot(i).path;
 		bool valid = false;
-		Variant v = get_indexed(prop.get_names(), &valid);
+		Variant v = _get_property(accessors[i], &valid);
 
 		// we must fail here, since we need to know the exact property type to serialize it later
 		// it is possible to pass in null for invalid properties and still make this work
@@ -113,9 +378,30 @@ void NetworkInput::gather() {
 		// input usually must be deterministic and fully known beforehand between server and clients
 		ERR_FAIL_COND_MSG(!valid, vformat("Property '%s' not found.", prop));
 
-		frame.properties.insert(prop, v);
+		// the slot carries the declared type, an untyped value converts to it
+		const Variant::Type type = schema.get_slot(i).type;
+		if (v.get_type() != type) {
+			ERR_FAIL_COND_MSG(!Variant::can_convert_strict(v.get_type(), type), vformat("Property '%s' cannot be converted to %s.", prop, Variant::get_type_name(type)));
+			const Variant *args[1] = { &v };
+			Callable::CallError ce;
+			Variant converted;
+			Variant::construct(type, converted, args, 1, ce);
+			ERR_FAIL_COND_MSG(ce.error != Callable::CallError::CALL_OK, vformat("Property '%s' cannot be converted to %s.", prop, Variant::get_type_name(type)));
+			v = converted;
+		}
+
+		// keep locally exactly what the server will decode, prediction stays deterministic
+		Variant &snapped = gather_row[i];
+		snapped = v;
+		schema.snap(i, snapped);
+		if (!snapped.hash_compare(v)) {
+			_set_property(accessors[i], snapped);
+		}
 	}
 
+	InputFrame frame;
+	frame.frame_id = _current_frame_id;
+	frame.values = Span<Variant>(gather_row.ptr(), gather_row.size());
 	write_frame(frame);
 
 	GDVIRTUAL_CALL(_input_applied);
@@ -123,35 +409,198 @@ void NetworkInput::gather() {
 
 void NetworkInput::replay() {
 	ERR_FAIL_COND(replica_config.is_null());
-	const Vector<NodePath> props = replica_config->get_replica_properties();
 
-	if (buffer.data_left() == 0) {
-		return; // TODO: replay the oldest
+	// frames arriving after their tick has been predicted are stale
+	while (!buffer.is_empty()) {
+		if (_get_frame(0).frame_id > last_replayed_frame_id) {
+			break;
+		}
+		_pop_frame();
+		dropped_frames++;
 	}
 
-	InputFrame frame = buffer.read();
+	const int target = get_target_buffer_depth();
+
+	if (buffering) {
+		if (buffer.size() < target) {
+			return; // fill up before the first replay
+		}
+		buffering = false;
+	}
+
+	if (buffer.is_empty()) {
+		starved_frames++;
+		_predict_frame();
+		GDVIRTUAL_CALL(_input_applied);
+		return;
+	}
+
+	const InputFrame frame = _pop_frame();
 	ERR_FAIL_COND(frame.frame_id == 0);
-	for (const NodePath &prop : props) {
-		ERR_CONTINUE_MSG(!frame.properties.has(prop), vformat("Property '%s' not found in input frame.", prop));
-		set_indexed(prop.get_names(), frame.properties[prop]);
+
+	// over-full, catch up one frame per tick
+	// the skipped frame is merged into the next one so a press is not lost
+	if (buffer.size() >= target + JITTER_BUFFER_SLACK) {
+		const InputFrame next = _pop_frame();
+		ERR_FAIL_COND(next.values.size() != frame.values.size());
+
+		for (uint32_t i = 0; i < next.values.size(); i++) {
+			const Variant &skipped = frame.values[i];
+			Variant &value = last_replayed_values[i];
+			value = next.values[i];
+			if (skipped.get_type() == Variant::BOOL && value.get_type() == Variant::BOOL) {
+				value = skipped.operator bool() || value.operator bool();
+			}
+		}
+		dropped_frames++;
+
+		InputFrame merged;
+		merged.frame_id = next.frame_id;
+		merged.values = Span<Variant>(last_replayed_values.ptr(), last_replayed_values.size());
+		_apply_frame(merged);
+	} else {
+		_apply_frame(frame);
 	}
 
 	GDVIRTUAL_CALL(_input_applied);
 }
 
+// The frame at p_index, 0 being the oldest, read in place.
+InputFrame NetworkInput::_get_frame(int p_index) const {
+	const int slots = schema.size();
+
+	InputFrame frame;
+	frame.frame_id = buffer.at(p_index);
+	frame.values = Span<Variant>(buffer_values.ptr() + buffer.get_slot(p_index) * slots, slots);
+	return frame;
+}
+
+// Removes the oldest frame, the returned row stays valid until the next write.
+InputFrame NetworkInput::_pop_frame() {
+	const InputFrame frame = _get_frame(0);
+	buffer.set_size(buffer.size() - 1); // the oldest goes first, the slot is left untouched
+	return frame;
+}
+
+void NetworkInput::_apply_frame(const InputFrame &p_frame) {
+	ERR_FAIL_COND_MSG(p_frame.values.size() != uint32_t(schema.size()), "Input frame does not match the schema.");
+
+	for (int i = 0; i < schema.size(); i++) {
+		_set_property(accessors[i], p_frame.values[i]);
+	}
+
+	// the row has its capacity since the schema was compiled, no allocation
+	if (p_frame.values.ptr() != last_replayed_values.ptr()) {
+		for (int i = 0; i < schema.size(); i++) {
+			last_replayed_values[i] = p_frame.values[i];
+		}
+	}
+	last_replayed_frame_id = p_frame.frame_id;
+}
+
+void NetworkInput::_predict_frame() {
+	if (last_replayed_frame_id == 0) {
+		return; // nothing to predict from
+	}
+
+	// predicted in place, it becomes the last replayed frame anyway
+	if (starvation_mode == STARVATION_RESET) {
+		for (Variant &value : last_replayed_values) {
+			Callable::CallError ce;
+			Variant::construct(value.get_type(), value, nullptr, 0, ce);
+		}
+	}
+
+	InputFrame frame;
+	frame.frame_id = last_replayed_frame_id + 1; // the missing frame takes this tick, the real one is stale once it arrives
+	frame.values = Span<Variant>(last_replayed_values.ptr(), last_replayed_values.size());
+	_apply_frame(frame);
+}
+
+// RFC 3550 interarrival jitter, measured on the first new frame of each packet
+void NetworkInput::_track_arrival(uint64_t p_frame_id) {
+	const uint64_t tick = Network::get_singleton()->get_network_frames();
+	if (tick == arrival_tick) {
+		return; // same packet
+	}
+
+	if (arrival_tick != 0) {
+		const int64_t d = int64_t(tick - arrival_tick) - int64_t(p_frame_id - arrival_frame_id);
+		arrival_jitter += (Math::abs(double(d)) - arrival_jitter) / 16.0;
+	}
+
+	arrival_tick = tick;
+	arrival_frame_id = p_frame_id;
+}
+
+int NetworkInput::get_target_buffer_depth() const {
+	// batched frames drain between two packets, jitter on top of that
+	const int batch = Network::get_singleton()->get_frames_per_network_tick() - 1;
+	const int target = jitter_buffer_min_depth + batch + int(Math::ceil(2.0 * arrival_jitter));
+	return CLAMP(target, jitter_buffer_min_depth, jitter_buffer_max_depth);
+}
+
+void NetworkInput::set_starvation_mode(StarvationMode p_mode) {
+	starvation_mode = p_mode;
+}
+
+NetworkInput::StarvationMode NetworkInput::get_starvation_mode() const {
+	return starvation_mode;
+}
+
+void NetworkInput::set_jitter_buffer_min_depth(int p_depth) {
+	jitter_buffer_min_depth = CLAMP(p_depth, 0, JITTER_BUFFER_LIMIT);
+	jitter_buffer_max_depth = MAX(jitter_buffer_max_depth, jitter_buffer_min_depth);
+}
+
+int NetworkInput::get_jitter_buffer_min_depth() const {
+	return jitter_buffer_min_depth;
+}
+
+void NetworkInput::set_jitter_buffer_max_depth(int p_depth) {
+	jitter_buffer_max_depth = CLAMP(p_depth, 0, JITTER_BUFFER_LIMIT);
+	jitter_buffer_min_depth = MIN(jitter_buffer_min_depth, jitter_buffer_max_depth);
+}
+
+int NetworkInput::get_jitter_buffer_max_depth() const {
+	return jitter_buffer_max_depth;
+}
+
 void NetworkInput::write_frame(const InputFrame &p_frame) {
 	ERR_FAIL_COND_MSG(p_frame.frame_id == 0, "Input frame is uninitialized.");
+	ERR_FAIL_COND_MSG(p_frame.values.size() != uint32_t(schema.size()), "Input frame does not match the schema.");
 
-	if (buffer.space_left() == 0) {
-		buffer.advance_read(1);
+	if (!is_multiplayer_authority()) {
+		_track_arrival(p_frame.frame_id);
+	}
+
+	if (buffer.size() == buffer.capacity()) {
+		dropped_frames++; // the oldest frame is overwritten
+	}
+	buffer.append(p_frame.frame_id);
+
+	const int slots = schema.size();
+	Variant *row = buffer_values.ptr() + buffer.get_slot(buffer.size() - 1) * slots;
+	for (int i = 0; i < slots; i++) {
+		row[i] = p_frame.values[i];
 	}
-	buffer.write(p_frame);
 	last_aknownedged_input_id = p_frame.frame_id;
 }
 
 void NetworkInput::reset() {
 	_samples.clear();
+	for (SlotSample &sample : slot_samples) {
+		sample = SlotSample();
+	}
 	buffer.clear();
+	last_replayed_frame_id = 0;
+
+	arrival_jitter = 0;
+	arrival_tick = 0;
+	arrival_frame_id = 0;
+	buffering = true;
+	starved_frames = 0;
+	dropped_frames = 0;
 }
 
 bool NetworkInput::is_input_authority() const {
@@ -179,13 +628,36 @@ void NetworkInput::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_replica_config"), &NetworkInput::get_replica_config);
 
 	ClassDB::bind_method(D_METHOD("sample", "property", "value"), &NetworkInput::sample);
+	ClassDB::bind_method(D_METHOD("sample_many", "property", "values"), &NetworkInput::sample_many);
 	ClassDB::bind_method(D_METHOD("is_input_authority"), &NetworkInput::is_input_authority);
 
+	ClassDB::bind_method(D_METHOD("set_starvation_mode", "mode"), &NetworkInput::set_starvation_mode);
+	ClassDB::bind_method(D_METHOD("get_starvation_mode"), &NetworkInput::get_starvation_mode);
+	ClassDB::bind_method(D_METHOD("set_jitter_buffer_min_depth", "depth"), &NetworkInput::set_jitter_buffer_min_depth);
+	ClassDB::bind_method(D_METHOD("get_jitter_buffer_min_depth"), &NetworkInput::get_jitter_buffer_min_depth);
+	ClassDB::bind_method(D_METHOD("set_jitter_buffer_max_depth", "depth"), &NetworkInput::set_jitter_buffer_max_depth);
+	ClassDB::bind_method(D_METHOD("get_jitter_buffer_max_depth"), &NetworkInput::get_jitter_buffer_max_depth);
+
+	ClassDB::bind_method(D_METHOD("get_buffer_depth"), &NetworkInput::get_buffer_depth);
+	ClassDB::bind_method(D_METHOD("get_target_buffer_depth"), &NetworkInput::get_target_buffer_depth);
+	ClassDB::bind_method(D_METHOD("get_arrival_jitter"), &NetworkInput::get_arrival_jitter);
+	ClassDB::bind_method(D_METHOD("get_starved_frames"), &NetworkInput::get_starved_frames);
+	ClassDB::bind_method(D_METHOD("get_dropped_frames"), &NetworkInput::get_dropped_frames);
+
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "replica_config", PROPERTY_HINT_RESOURCE_TYPE, "NetworkInputReplicaConfig", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_EDITOR_INSTANTIATE_OBJECT), "set_replica_config", "get_replica_config");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "starvation_mode", PROPERTY_HINT_ENUM, "Repeat Last,Reset"), "set_starvation_mode", "get_starvation_mode");
+
+	ADD_GROUP("Jitter Buffer", "jitter_buffer_");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "jitter_buffer_min_depth", PROPERTY_HINT_RANGE, "0,32,1"), "set_jitter_buffer_min_depth", "get_jitter_buffer_min_depth");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "jitter_buffer_max_depth", PROPERTY_HINT_RANGE, "0,32,1"), "set_jitter_buffer_max_depth", "get_jitter_buffer_max_depth");
+
+	BIND_ENUM_CONSTANT(STARVATION_REPEAT_LAST);
+	BIND_ENUM_CONSTANT(STARVATION_RESET);
 }
 
 NetworkInput::NetworkInput() {
-	buffer.resize(6); // 2^6 = 64 frames
+	buffer.set_power_of_two(true);
+	buffer.resize(64);
 }
 
 void NetworkInput::_start() {
@@ -194,7 +666,17 @@ void NetworkInput::_start() {
 		return;
 	}
 #endif
+	if (!is_inside_tree()) {
+		return; // no path and no multiplayer yet
+	}
+
 	reset();
+
+	// the same on every peer, as long as the node paths match
+	input_id = String(get_path()).hash();
+
+	_compile_schema();
+
 	get_multiplayer()->object_configuration_add(this, this);
 }
 
@@ -204,6 +686,10 @@ void NetworkInput::_stop() {
 		return;
 	}
 #endif
+	if (!is_inside_tree()) {
+		return; // never started
+	}
+
 	get_multiplayer()->object_configuration_remove(this, this);
 	reset();
 }
@@ -1,19 +1,29 @@
 #pragma once
 
+#include "circular_buffer.h"
+#include "input_schema.h"
 #include "network_input_replica_config.h"
 
 #include "core/object/ref_counted.h"
 #include "scene/main/multiplayer_api.h"
 #include "scene/main/node.h"
 
+// a view of one frame, the values are a row in the slot order of the input schema
+// rows are owned by whoever produced the view, the ring of the input, a decoder or a scratch row
 struct InputFrame {
 	uint64_t frame_id = 0; // 0 means uninitialized
-	HashMap<NodePath, Variant> properties;
+	Span<Variant> values;
 };
 
 class NetworkInput : public Node {
 	GDCLASS(NetworkInput, Node)
 
+public:
+	enum StarvationMode {
+		STARVATION_REPEAT_LAST,
+		STARVATION_RESET,
+	};
+
 private:
 	struct InputSample {
 		uint32_t samples = 0;
@@ -21,13 +31,80 @@ private:
 	};
 
 	// TODO: Use StringName instead of NodePath?
-	HashMap<NodePath, InputSample> _samples;
+	HashMap<NodePath, InputSample> _samples; // properties outside the replica config
+
+	// typed accumulator of a schema slot, sampling does no Variant arithmetic
+	struct SlotSample {
+		uint32_t samples = 0;
+		double real[4] = {}; // float and vector components
+		int64_t integer[4] = {}; // int and integer vector components
+		bool pressed = false; // bools are or-ed over the tick
+		Variant latest; // any other type keeps the last sample
+	};
+
+	LocalVector<SlotSample> slot_samples; // in schema slot order
+	HashMap<NodePath, int> slot_indices;
+
+	static void _accumulate(SlotSample &r_sample, Variant::Type p_type, const Variant &p_value);
+	static Variant _average(const SlotSample &p_sample, Variant::Type p_type);
+	template <typename T>
+	void _sample_array(const NodePath &p_property, const Vector<T> &p_values);
 
 	uint64_t _current_frame_id = 0;
 	uint64_t last_aknownedged_input_id = 0;
-	RingBuffer<InputFrame> buffer;
+	uint64_t last_replayed_frame_id = 0;
+	// one flat array for the whole ring, row i belongs to slot i of the frame ids
+	// input values are bools, numbers and vectors, stored inline in the Variant, writing a row does not allocate
+	CircularStorage<uint64_t> buffer; // frame ids, oldest first
+	LocalVector<Variant> buffer_values; // capacity rows of schema size values
+	LocalVector<Variant> gather_row; // scratch row, filled by gather before it goes in the ring
+
+	// server side jitter buffer, the depth follows the arrival jitter of the client
+	static constexpr int JITTER_BUFFER_SLACK = 2; // frames over the target before catching up
+	static constexpr int JITTER_BUFFER_LIMIT = 32;
+
+	StarvationMode starvation_mode = STARVATION_REPEAT_LAST;
+	int jitter_buffer_min_depth = 1;
+	int jitter_buffer_max_depth = 16;
+
+	LocalVector<Variant> last_replayed_values; // prediction base when starved
+	double arrival_jitter = 0; // in ticks
+	uint64_t arrival_tick = 0;
+	uint64_t arrival_frame_id = 0;
+	bool buffering = true; // filling up before the first replay
+	uint64_t starved_frames = 0;
+	uint64_t dropped_frames = 0;
+
+	void _track_arrival(uint64_t p_frame_id);
+	InputFrame _get_frame(int p_index) const;
+	InputFrame _pop_frame();
+	void _apply_frame(const InputFrame &p_frame);
+	void _predict_frame();
+
+	// a replicated property resolved once, gather and replay skip the generic property lookup
+	struct PropertyAccessor {
+		enum Mode {
+			ACCESS_GENERIC, // nested paths and dynamic properties
+			ACCESS_SCRIPT,
+			ACCESS_NATIVE,
+		};
+
+		Mode mode = ACCESS_GENERIC;
+		Vector<StringName> names;
+		StringName name;
+		MethodBind *getter = nullptr;
+		MethodBind *setter = nullptr;
+		int index = -1; // indexed native properties take it as the first argument
+	};
 
 	Ref<NetworkInputReplicaConfig> replica_config;
+	InputSchema schema; // wire layout of replica_config
+	LocalVector<PropertyAccessor> accessors; // in schema slot order
+	uint32_t input_id = 0; // hash of the node path, identifies the input section in a packet
+
+	void _compile_schema();
+	Variant _get_property(const PropertyAccessor &p_accessor, bool *r_valid);
+	void _set_property(const PropertyAccessor &p_accessor, const Variant &p_value);
 
 	void _start();
 	void _stop();
@@ -45,19 +122,40 @@ public:
 
 	void set_replica_config(Ref<NetworkInputReplicaConfig> p_config);
 	Ref<NetworkInputReplicaConfig> get_replica_config();
+	const InputSchema &get_schema() const { return schema; }
+	uint32_t get_input_id() const { return input_id; }
 
 	void sample(const NodePath &p_property, const Variant &p_value);
+	void sample_many(const NodePath &p_property, const Variant &p_values);
 
 	void gather();
 	void replay();
 
-	Error copy_buffer(Vector<InputFrame> &frames, int p_count);
+	// Fills r_frames with the newest p_count frames, oldest first, as views into the buffer invalidated by any write.
+	int get_buffered_frames(int p_count, LocalVector<InputFrame> &r_frames) const;
+	// Copies the values of p_frame into the ring.
 	void write_frame(const InputFrame &p_frame);
 
 	bool is_input_authority() const;
 
+	void set_starvation_mode(StarvationMode p_mode);
+	StarvationMode get_starvation_mode() const;
+	void set_jitter_buffer_min_depth(int p_depth);
+	int get_jitter_buffer_min_depth() const;
+	void set_jitter_buffer_max_depth(int p_depth);
+	int get_jitter_buffer_max_depth() const;
+
+	int get_buffer_depth() const { return buffer.size(); }
+	int get_target_buffer_depth() const;
+	double get_arrival_jitter() const { return arrival_jitter; }
+	uint64_t get_starved_frames() const { return starved_frames; }
+	uint64_t get_dropped_frames() const { return dropped_frames; }
+
 	// command_id
 	int get_current_frame() const { return last_aknownedged_input_id; }
+	uint64_t get_last_replayed_frame() const { return last_replayed_frame_id; }
 
 	NetworkInput();
 };
+
+VARIANT_ENUM_CAST(NetworkInput::StarvationMode);
@@ -14,6 +14,29 @@ bool NetworkInputReplicaConfig::_set(const StringName &p_name, const Variant &p_
 			add_property(path);
 			return true;
 		}
+
+		ERR_FAIL_INDEX_V(idx, properties.size(), false);
+		InputProperty &prop = properties.get(idx);
+		if (what == "precision") {
+			prop.precision = PropertyPrecision(int(p_value));
+			return true;
+		}
+		if (what == "quantization_bits") {
+			prop.quantization_bits = CLAMP(int(p_value), 0, 32);
+			return true;
+		}
+		if (what == "range_min") {
+			prop.range_min = p_value;
+			return true;
+		}
+		if (what == "range_max") {
+			prop.range_max = p_value;
+			return true;
+		}
+		if (what == "deadzone") {
+			prop.deadzone = p_value;
+			return true;
+		}
 	}
 	return false;
 }
@@ -30,6 +53,26 @@ bool NetworkInputReplicaConfig::_get(const StringName &p_name, Variant &r_ret) c
 			r_ret = prop.name;
 			return true;
 		}
+		if (what == "precision") {
+			r_ret = prop.precision;
+			return true;
+		}
+		if (what == "quantization_bits") {
+			r_ret = prop.quantization_bits;
+			return true;
+		}
+		if (what == "range_min") {
+			r_ret = prop.range_min;
+			return true;
+		}
+		if (what == "range_max") {
+			r_ret = prop.range_max;
+			return true;
+		}
+		if (what == "deadzone") {
+			r_ret = prop.deadzone;
+			return true;
+		}
 	}
 	return false;
 }
@@ -37,11 +80,24 @@ bool NetworkInputReplicaConfig::_get(const StringName &p_name, Variant &r_ret) c
 void NetworkInputReplicaConfig::_get_property_list(List<PropertyInfo> *p_list) const {
 	for (int i = 0; i < properties.size(); i++) {
 		p_list->push_back(PropertyInfo(Variant::STRING, "properties/" + itos(i) + "/path", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::INT, "properties/" + itos(i) + "/precision", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::INT, "properties/" + itos(i) + "/quantization_bits", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::FLOAT, "properties/" + itos(i) + "/range_min", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::FLOAT, "properties/" + itos(i) + "/range_max", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::FLOAT, "properties/" + itos(i) + "/deadzone", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
 	}
 }
 
 void NetworkInputReplicaConfig::reset_state() {
 	properties.clear();
+	_update_replica_properties();
+}
+
+void NetworkInputReplicaConfig::_update_replica_properties() {
+	replica_props.clear();
+	for (const InputProperty &prop : properties) {
+		replica_props.push_back(prop.name);
+	}
 }
 
 TypedArray<NodePath> NetworkInputReplicaConfig::get_properties() const {
@@ -52,13 +108,35 @@ TypedArray<NodePath> NetworkInputReplicaConfig::get_properties() const {
 	return paths;
 }
 
+NetworkInputReplicaConfig::InputProperty *NetworkInputReplicaConfig::_get_property(const NodePath &p_path) {
+	for (InputProperty &property : properties) {
+		if (property.name == p_path) {
+			return &property;
+		}
+	}
+	return nullptr;
+}
+
+const NetworkInputReplicaConfig::InputProperty *NetworkInputReplicaConfig::_get_property(const NodePath &p_path) const {
+	for (const InputProperty &property : properties) {
+		if (property.name == p_path) {
+			return &property;
+		}
+	}
+	return nullptr;
+}
+
 void NetworkInputReplicaConfig::add_property(const NodePath &p_path, int p_index) {
 	ERR_FAIL_COND(p_path == NodePath());
 
+	// moving an existing property keeps its settings
+	const InputProperty *existing = _get_property(p_path);
+	const InputProperty property = existing ? *existing : InputProperty(p_path);
+
 	properties.erase(p_path);
 
 	if (p_index < 0 || p_index >= properties.size()) {
-		properties.push_back(InputProperty(p_path));
+		properties.push_back(property);
 	} else {
 		List<InputProperty>::Element *I = properties.front();
 		int c = 0;
@@ -66,17 +144,15 @@ void NetworkInputReplicaConfig::add_property(const NodePath &p_path, int p_index
 			I = I->next();
 			c++;
 		}
-		properties.insert_before(I, InputProperty(p_path));
+		properties.insert_before(I, property);
 	}
 
-	replica_props.clear();
-	for (const InputProperty &prop : properties) {
-		replica_props.push_back(prop.name);
-	}
+	_update_replica_properties();
 }
 
 void NetworkInputReplicaConfig::remove_property(const NodePath &p_path) {
 	properties.erase(p_path);
+	_update_replica_properties();
 }
 
 bool NetworkInputReplicaConfig::has_property(const NodePath &p_path) const {
@@ -98,6 +174,64 @@ int NetworkInputReplicaConfig::property_get_index(const NodePath &p_path) const
 	ERR_FAIL_V(-1);
 }
 
+void NetworkInputReplicaConfig::property_set_precision(const NodePath &p_path, PropertyPrecision p_precision) {
+	InputProperty *property = _get_property(p_path);
+	ERR_FAIL_NULL(property);
+	property->precision = p_precision;
+}
+
+NetworkInputReplicaConfig::PropertyPrecision NetworkInputReplicaConfig::property_get_precision(const NodePath &p_path) const {
+	const InputProperty *property = _get_property(p_path);
+	ERR_FAIL_NULL_V(property, PRECISION_FULL);
+	return property->precision;
+}
+
+void NetworkInputReplicaConfig::property_set_quantization_bits(const NodePath &p_path, int p_bits) {
+	ERR_FAIL_COND_MSG(p_bits < 0 || p_bits > 32, "Quantization bits must be between 0 (disabled) and 32.");
+	InputProperty *property = _get_property(p_path);
+	ERR_FAIL_NULL(property);
+	property->quantization_bits = p_bits;
+}
+
+int NetworkInputReplicaConfig::property_get_quantization_bits(const NodePath &p_path) const {
+	const InputProperty *property = _get_property(p_path);
+	ERR_FAIL_NULL_V(property, 0);
+	return property->quantization_bits;
+}
+
+void NetworkInputReplicaConfig::property_set_range(const NodePath &p_path, double p_min, double p_max) {
+	ERR_FAIL_COND_MSG(p_min >= p_max, "Range min must be lower than range max.");
+	InputProperty *property = _get_property(p_path);
+	ERR_FAIL_NULL(property);
+	property->range_min = p_min;
+	property->range_max = p_max;
+}
+
+double NetworkInputReplicaConfig::property_get_range_min(const NodePath &p_path) const {
+	const InputProperty *property = _get_property(p_path);
+	ERR_FAIL_NULL_V(property, -1.0);
+	return property->range_min;
+}
+
+double NetworkInputReplicaConfig::property_get_range_max(const NodePath &p_path) const {
+	const InputProperty *property = _get_property(p_path);
+	ERR_FAIL_NULL_V(property, 1.0);
+	return property->range_max;
+}
+
+void NetworkInputReplicaConfig::property_set_deadzone(const NodePath &p_path, double p_deadzone) {
+	ERR_FAIL_COND(p_deadzone < 0);
+	InputProperty *property = _get_property(p_path);
+	ERR_FAIL_NULL(property);
+	property->deadzone = p_deadzone;
+}
+
+double NetworkInputReplicaConfig::property_get_deadzone(const NodePath &p_path) const {
+	const InputProperty *property = _get_property(p_path);
+	ERR_FAIL_NULL_V(property, 0.0);
+	return property->deadzone;
+}
+
 const Vector<NodePath> &NetworkInputReplicaConfig::get_replica_properties() {
 	return replica_props;
 }
@@ -109,4 +243,17 @@ void NetworkInputReplicaConfig::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("remove_property", "path"), &NetworkInputReplicaConfig::remove_property);
 	ClassDB::bind_method(D_METHOD("property_get_index", "path"), &NetworkInputReplicaConfig::property_get_index);
 	// ClassDB::bind_method(D_METHOD("property_set_index", "path", "index"), &NetworkInputReplicaConfig::property_set_index);
+	ClassDB::bind_method(D_METHOD("property_set_precision", "path", "precision"), &NetworkInputReplicaConfig::property_set_precision);
+	ClassDB::bind_method(D_METHOD("property_get_precision", "path"), &NetworkInputReplicaConfig::property_get_precision);
+	ClassDB::bind_method(D_METHOD("property_set_quantization_bits", "path", "bits"), &NetworkInputReplicaConfig::property_set_quantization_bits);
+	ClassDB::bind_method(D_METHOD("property_get_quantization_bits", "path"), &NetworkInputReplicaConfig::property_get_quantization_bits);
+	ClassDB::bind_method(D_METHOD("property_set_range", "path", "min", "max"), &NetworkInputReplicaConfig::property_set_range);
+	ClassDB::bind_method(D_METHOD("property_get_range_min", "path"), &NetworkInputReplicaConfig::property_get_range_min);
+	ClassDB::bind_method(D_METHOD("property_get_range_max", "path"), &NetworkInputReplicaConfig::property_get_range_max);
+	ClassDB::bind_method(D_METHOD("property_set_deadzone", "path", "deadzone"), &NetworkInputReplicaConfig::property_set_deadzone);
+	ClassDB::bind_method(D_METHOD("property_get_deadzone", "path"), &NetworkInputReplicaConfig::property_get_deadzone);
+
+	BIND_ENUM_CONSTANT(PRECISION_FULL);
+	BIND_ENUM_CONSTANT(PRECISION_SINGLE);
+	BIND_ENUM_CONSTANT(PRECISION_HALF);
 }
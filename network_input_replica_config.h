@@ -7,9 +7,24 @@ class NetworkInputReplicaConfig : public Resource {
 	GDCLASS(NetworkInputReplicaConfig, Resource);
 	OBJ_SAVE_TYPE(NetworkInputReplicaConfig);
 
+public:
+	// wire precision of the float components, see InputSchema
+	enum PropertyPrecision {
+		PRECISION_FULL,
+		PRECISION_SINGLE,
+		PRECISION_HALF,
+	};
+
 private:
 	struct InputProperty {
 		NodePath name;
+		PropertyPrecision precision = PRECISION_FULL;
+
+		// fixed-point quantization of the float components, 0 bits disables it
+		int quantization_bits = 0;
+		double range_min = -1.0;
+		double range_max = 1.0;
+		double deadzone = 0.0;
 
 		bool operator==(const InputProperty &p_to) {
 			return name == p_to.name;
@@ -27,6 +42,10 @@ private:
 	List<InputProperty> properties;
 	Vector<NodePath> replica_props;
 
+	void _update_replica_properties();
+	InputProperty *_get_property(const NodePath &p_path);
+	const InputProperty *_get_property(const NodePath &p_path) const;
+
 protected:
 	static void _bind_methods();
 
@@ -45,5 +64,18 @@ public:
 
 	int property_get_index(const NodePath &p_path) const;
 
+	void property_set_precision(const NodePath &p_path, PropertyPrecision p_precision);
+	PropertyPrecision property_get_precision(const NodePath &p_path) const;
+
+	void property_set_quantization_bits(const NodePath &p_path, int p_bits);
+	int property_get_quantization_bits(const NodePath &p_path) const;
+	void property_set_range(const NodePath &p_path, double p_min, double p_max);
+	double property_get_range_min(const NodePath &p_path) const;
+	double property_get_range_max(const NodePath &p_path) const;
+	void property_set_deadzone(const NodePath &p_path, double p_deadzone);
+	double property_get_deadzone(const NodePath &p_path) const;
+
 	const Vector<NodePath> &get_replica_properties();
 };
+
+VARIANT_ENUM_CAST(NetworkInputReplicaConfig::PropertyPrecision);
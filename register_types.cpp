@@ -8,6 +8,7 @@
 #include "network_input_replica_config.h"
 #include "rollback_multiplayer.h"
 #include "rollback_tree.h"
+#include "spsc_circular_buffer.h"
 
 #ifdef TOOLS_ENABLED
 #include "debug/rollback_debugger.h"
@@ -21,6 +22,12 @@ static Network *_network = nullptr;
 void initialize_voidine_sdk_module(ModuleInitializationLevel p_level) {
 	if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
 		GDREGISTER_CLASS(CircularBuffer);
+		GDREGISTER_CLASS(CircularBufferFloat);
+		GDREGISTER_CLASS(CircularBufferInt);
+		GDREGISTER_CLASS(CircularBufferVector2);
+		GDREGISTER_CLASS(CircularBufferVector3);
+		GDREGISTER_CLASS(CircularBufferTransform3D);
+		GDREGISTER_CLASS(SPSCCircularBuffer);
 
 		GDREGISTER_CLASS(ReferenceClock);
 		GDREGISTER_CLASS(SimulationClock);
@@ -6,6 +6,7 @@
 
 #include "modules/enet/enet_multiplayer_peer.h"
 
+#include "core/config/engine.h"
 #include "core/io/marshalls.h"
 #include "core/os/os.h"
 #include "scene/main/scene_tree.h"
@@ -17,7 +18,12 @@ bool RollbackMultiplayer::is_online_server() const {
 
 void RollbackMultiplayer::set_multiplayer_peer(const Ref<MultiplayerPeer> &p_peer) {
 	SceneMultiplayer::set_multiplayer_peer(p_peer);
+
+	const RollbackState state = last_rollback_state;
 	_update_rollback_state();
+	if (last_rollback_state == state) {
+		input_replication->rebuild_inputs(); // same role, the unique id may still differ
+	}
 }
 
 Error RollbackMultiplayer::object_configuration_add(Object *p_obj, Variant p_config) {
@@ -75,23 +81,76 @@ Error RollbackMultiplayer::poll() {
 	Error err = SceneMultiplayer::poll();
 	_update_rollback_state();
 
-	if (rollback_state == ROLLBACK_STATE_CLIENT) {
-		if (ping_timer.elapsed()) {
-			err = ping();
-		}
+	// fire the due periodic jobs, ping included
+	Network::get_singleton()->timer_wheel.advance(FrameTime::sample());
+
+	if (rollback_state == ROLLBACK_STATE_CLIENT && clock_synchronized) {
+		_slew_clock();
 	}
 
 	return err;
 }
 
+void RollbackMultiplayer::_ping_timeout() {
+	if (rollback_state != ROLLBACK_STATE_CLIENT) {
+		return;
+	}
+
+	if (clock_synchronized) {
+		// input acks already carry the samples, ping only when they stop coming
+		if (get_frame_time() - last_sample_time >= ping_interval) {
+			ping();
+		}
+	} else {
+		_bootstrap_clock();
+	}
+}
+
+void RollbackMultiplayer::_bootstrap_clock() {
+	if (bootstrap_sent < BOOTSTRAP_PINGS) {
+		if (ping() == OK) {
+			bootstrap_sent++;
+			bootstrap_last_sent = get_frame_time();
+		}
+		return;
+	}
+
+	if (get_frame_time() - bootstrap_last_sent < BOOTSTRAP_TIMEOUT) {
+		return; // still waiting for pongs
+	}
+
+	if (bootstrap_received > 0) {
+		_finish_bootstrap();
+	} else {
+		bootstrap_sent = 0; // everything was lost, burst again
+	}
+}
+
+void RollbackMultiplayer::_finish_bootstrap() {
+	clock_synchronized = true;
+
+	// the estimator only trusts the samples close to the minimum RTT of the burst
+	ReferenceClock *reference_clock = Network::get_singleton()->_reference_clock_ptr;
+	reference_clock->set_offset(clock_estimator.get_offset(get_frame_time()));
+	Network::get_singleton()->_simulation_clock_ptr->set_time(reference_clock->get_time());
+
+	const double elapsed = MAX(0.0, reference_clock->get_time() - bootstrap_server_time);
+	Network::get_singleton()->_network_frames = bootstrap_server_tick + uint64_t(elapsed * Engine::get_singleton()->get_physics_ticks_per_second());
+
+	// maintenance mode
+	_set_ping_interval(PING_INTERVAL_MIN);
+
+	emit_signal(SNAME("clock_synchronized"));
+}
+
 Error RollbackMultiplayer::ping() {
 	ERR_FAIL_COND_V_MSG(get_unique_id() == 1, ERR_UNAVAILABLE, "Server cannot send ping to itself.");
 	ERR_FAIL_COND_V_MSG(!SceneMultiplayer::get_connected_peers().has(MultiplayerPeer::TARGET_PEER_SERVER), ERR_UNAVAILABLE, "Cannot send ping to server when not connected.");
 
 	// get a new sample
 	++sample_index;
-	PingSample sample;
-	sample.ping_sent = Network::get_singleton()->_reference_clock_ptr->get_time();
+	ClockEstimator::Sample sample;
+	sample.local_sent = get_wall_time();
 	awaiting_samples[sample_index] = sample;
 
 	Vector<uint8_t> packet;
@@ -124,6 +183,8 @@ void RollbackMultiplayer::_process_packet(int p_from, const uint8_t *p_packet, i
 						_process_ping(p_from, &p_packet[2], p_packet_len - 2);
 					} else if (p_packet[1] == COMMAND_PONG) {
 						_process_pong(p_from, &p_packet[2], p_packet_len - 2);
+					} else if (p_packet[1] == COMMAND_INPUT_ACK) {
+						input_replication->process_input_ack(p_from, &p_packet[2], p_packet_len - 2);
 					}
 					return;
 				}
@@ -167,7 +228,7 @@ void RollbackMultiplayer::_process_ping(int p_from, const uint8_t *p_packet, int
 		uint8_t *w = &packet.write[2];
 		memcpy(&w[0], &p_packet[0], 4); // copy back the idx
 
-		const double time = Network::get_singleton()->_reference_clock_ptr->get_time();
+		const double time = Network::get_singleton()->_reference_clock_ptr->get_precise_time();
 		const uint64_t ticks = Network::get_singleton()->_network_frames;
 
 		encode_double(time, &w[4]); // server clock raw
@@ -191,64 +252,163 @@ void RollbackMultiplayer::_process_pong(int p_from, const uint8_t *p_packet, int
 	const uint64_t server_tick = decode_uint64(&p_packet[12]);
 	const double last_rtt = p_packet_len >= 22 ? decode_half(&p_packet[20]) : 0;
 
-	const double pong_received = Network::get_singleton()->_reference_clock_ptr->get_time();
-
-	PingSample sample = awaiting_samples[idx];
+	ClockEstimator::Sample sample = awaiting_samples[idx];
 	awaiting_samples.erase(idx);
 
-	sample.ping_received = server_clock;
-	sample.pong_sent = server_clock;
-	sample.pong_received = pong_received;
+	sample.local_received = get_wall_time();
+	sample.remote = server_clock;
+
+	if (!clock_synchronized) {
+		clock_estimator.add_sample(sample);
 
-	if (sample_buffer.size() == 0) {
-		Network::get_singleton()->_reference_clock_ptr->set_time(server_clock);
-		Network::get_singleton()->_simulation_clock_ptr->set_time(Network::get_singleton()->_reference_clock_ptr->get_time());
-		Network::get_singleton()->_network_frames = Network::get_singleton()->_reference_clock_ptr->get_reference_frames();
-		Network::get_singleton()->_network_frames = server_tick; // TODO: do something here
+		// a delayed pong carries a stale tick, start from the fastest one
+		if (bootstrap_received == 0 || sample.get_rtt() < bootstrap_best_rtt) {
+			bootstrap_best_rtt = sample.get_rtt();
+			bootstrap_server_tick = server_tick;
+			bootstrap_server_time = server_clock;
+		}
+		bootstrap_received++;
+		if (bootstrap_received >= BOOTSTRAP_PINGS) {
+			_finish_bootstrap();
+		}
+		return;
 	}
 
-	sample_buffer.append(sample);
+	_add_clock_sample(sample);
+}
 
-	_adjust_clock();
+void RollbackMultiplayer::_add_clock_sample(const ClockEstimator::Sample &p_sample) {
+	const bool accepted = clock_estimator.add_sample(p_sample);
+	if (clock_synchronized) {
+		last_sample_time = get_frame_time();
+		_adjust_clock(accepted);
+	}
 }
 
-void RollbackMultiplayer::_adjust_clock() {
-	Vector<PingSample> sorted_samples = sample_buffer.sort_custom<PingSample::PingSampleSorter>();
+// samples echoed in the input acks, only the lowest RTT of each window reaches the estimator
+// so the window of the estimator still spans long enough to measure the drift
+void RollbackMultiplayer::_piggyback_clock_sample(const ClockEstimator::Sample &p_sample) {
+	const double now = get_frame_time();
 
-	ERR_FAIL_COND(sorted_samples.size() == 0); // should never happen
+	if (!piggyback_pending || p_sample.get_rtt() < piggyback_sample.get_rtt()) {
+		piggyback_sample = p_sample;
+	}
+
+	if (!piggyback_pending) {
+		piggyback_pending = true;
+		piggyback_window_start = now;
+	}
 
-	const double rtt_min = sorted_samples[0].get_rtt();
-	const double rtt_max = sorted_samples[sorted_samples.size() - 1].get_rtt();
+	if (now - piggyback_window_start >= PIGGYBACK_WINDOW) {
+		piggyback_pending = false;
+		_add_clock_sample(piggyback_sample);
+	}
+}
 
-	const double _rtt = (rtt_max + rtt_min) / 2;
-	const double _rtt_jitter = (rtt_max - rtt_min) / 2;
+void RollbackMultiplayer::_adjust_clock(bool p_accepted) {
+	ReferenceClock *clock = Network::get_singleton()->_reference_clock_ptr;
 
-	double offset = 0;
-	double offset_weight = 0;
-	for (uint32_t i = 0; i < sorted_samples.size(); ++i) {
-		const double rtt = sorted_samples[i].get_rtt();
-		const double sample_offset = sorted_samples[i].get_offset();
+	const double panic_threshold = 2.0; // seconds
+	const double error = clock_estimator.get_offset(get_frame_time()) - clock->offset;
 
-		const double weight = log(1.0 + double(rtt));
-		offset += sample_offset * weight;
-		offset_weight += weight;
+	if (Math::abs(error) > panic_threshold) {
+		// the estimate is way off, bootstrap again
+		awaiting_samples.clear();
+		clock_estimator.reset();
+		clock_synchronized = false;
+		bootstrap_sent = 0;
+		bootstrap_received = 0;
+		_set_ping_interval(BOOTSTRAP_INTERVAL);
+		return;
 	}
 
-	if (Math::is_zero_approx(offset_weight)) {
-		offset /= double(sorted_samples.size());
+	// ping less often once the offset and the drift are known, go back to the base rate on any outlier
+	if (p_accepted && clock_estimator.is_confident()) {
+		_set_ping_interval(MIN(ping_interval * 2.0, PING_INTERVAL_MAX));
 	} else {
-		offset /= offset_weight;
+		_set_ping_interval(PING_INTERVAL_MIN);
 	}
+}
 
-	const double panic_threshold = 2.0; // seconds
+// follow the estimated offset, drift included, between pongs
+void RollbackMultiplayer::_slew_clock() {
+	if (!clock_estimator.is_valid()) {
+		return;
+	}
+
+	const double max_slew = 0.002; // seconds per poll
 	const int adjust_steps = 8;
 
-	if (Math::abs(offset) > panic_threshold) {
-		// Network::get_singleton()->_reference_clock_ptr->adjust(offset);
-		awaiting_samples.clear();
-	} else {
-		const double nudge = offset / double(adjust_steps);
-		Network::get_singleton()->_reference_clock_ptr->adjust(nudge);
+	ReferenceClock *clock = Network::get_singleton()->_reference_clock_ptr;
+	const double error = clock_estimator.get_offset(get_frame_time()) - clock->offset;
+	clock->adjust(CLAMP(error / double(adjust_steps), -max_slew, max_slew));
+}
+
+double RollbackMultiplayer::PeerTiming::get_lead_hint() const {
+	// the jitter buffer already sizes itself after the arrival jitter, aiming anywhere else
+	// would fight its catch up: frames get skipped while the client is still slewing
+	const double target = MAX(double(target_depth), LEAD_SAFETY);
+	return target - lead_mean;
+}
+
+void RollbackMultiplayer::_track_input_lead(int p_peer, int64_t p_lead, int p_target_depth) {
+	PeerTiming &timing = peer_timings[p_peer];
+	timing.target_depth = p_target_depth;
+
+	if (p_lead <= 0) {
+		timing.late_count++; // arrived after its tick was replayed
+	}
+
+	const double lead = double(CLAMP(p_lead, -64, 64));
+	if (timing.samples++ == 0) {
+		timing.lead_mean = lead;
+		timing.lead_variance = 0;
+		return;
+	}
+
+	// exponentially weighted, follows the recent network conditions
+	const double delta = lead - timing.lead_mean;
+	timing.lead_mean += LEAD_SMOOTHING * delta;
+	timing.lead_variance = (1.0 - LEAD_SMOOTHING) * (timing.lead_variance + LEAD_SMOOTHING * delta * delta);
+}
+
+void RollbackMultiplayer::_apply_lead_hint(double p_hint) {
+	const double step = 1.0 / Engine::get_singleton()->get_physics_ticks_per_second();
+
+	Network *network = Network::get_singleton();
+	network->_input_lead = CLAMP(network->_input_lead + p_hint * step * LEAD_GAIN, 0.0, LEAD_MAX);
+}
+
+void RollbackMultiplayer::_peer_disconnected(int p_peer) {
+	peer_timings.erase(p_peer);
+	if (input_replication.is_valid()) {
+		input_replication->remove_peer(p_peer);
+	}
+}
+
+Dictionary RollbackMultiplayer::get_peer_timing(int p_peer) const {
+	Dictionary ret;
+	const PeerTiming *timing = peer_timings.getptr(p_peer);
+	if (timing) {
+		ret["lead_mean"] = timing->lead_mean;
+		ret["lead_variance"] = timing->lead_variance;
+		ret["late_count"] = timing->late_count;
+		ret["target_depth"] = timing->target_depth;
+		ret["lead_hint"] = timing->get_lead_hint();
+	}
+	return ret;
+}
+
+void RollbackMultiplayer::_set_ping_interval(double p_interval) {
+	if (Math::is_equal_approx(ping_interval, p_interval)) {
+		return;
+	}
+
+	ping_interval = p_interval;
+	if (ping_timer) {
+		TimerWheel &wheel = Network::get_singleton()->timer_wheel;
+		wheel.remove(ping_timer);
+		ping_timer = wheel.add(FrameTime::get_ticks_usec(), ping_interval, callable_mp(this, &RollbackMultiplayer::_ping_timeout));
 	}
 }
 
@@ -260,16 +420,54 @@ void RollbackMultiplayer::after_physic_process() {
 }
 
 void RollbackMultiplayer::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("is_clock_synchronized"), &RollbackMultiplayer::is_clock_synchronized);
+	ClassDB::bind_method(D_METHOD("get_peer_timing", "peer"), &RollbackMultiplayer::get_peer_timing);
+
+	ADD_SIGNAL(MethodInfo("clock_synchronized"));
 }
 
 RollbackMultiplayer::RollbackMultiplayer() {
 	input_replication.instantiate(this);
+	input_replication->rebuild_inputs(); // caches the role of the offline peer
+
+	connect(SNAME("peer_disconnected"), callable_mp(this, &RollbackMultiplayer::_peer_disconnected));
 }
 
 RollbackMultiplayer::~RollbackMultiplayer() {
+	if (ping_timer && Network::get_singleton()) {
+		Network::get_singleton()->timer_wheel.remove(ping_timer);
+	}
 	input_replication.unref();
 }
 
+void RollbackMultiplayer::_rollback_state_changed() {
+	TimerWheel &wheel = Network::get_singleton()->timer_wheel;
+
+	if (ping_timer) {
+		wheel.remove(ping_timer);
+		ping_timer = 0;
+	}
+
+	awaiting_samples.clear();
+	clock_estimator.reset();
+	clock_synchronized = false;
+	bootstrap_sent = 0;
+	bootstrap_received = 0;
+	piggyback_pending = false;
+	last_sample_time = 0;
+	ping_interval = BOOTSTRAP_INTERVAL;
+
+	peer_timings.clear();
+	Network::get_singleton()->_input_lead = 0;
+	input_replication->rebuild_inputs();
+
+	if (rollback_state == ROLLBACK_STATE_CLIENT) {
+		// start the sync burst right away, the timer keeps it going
+		_bootstrap_clock();
+		ping_timer = wheel.add(FrameTime::get_ticks_usec(), ping_interval, callable_mp(this, &RollbackMultiplayer::_ping_timeout));
+	}
+}
+
 void RollbackMultiplayer::_update_rollback_state() {
 	Ref<MultiplayerPeer> peer = SceneMultiplayer::get_multiplayer_peer();
 	MultiplayerPeer::ConnectionStatus status = peer.is_valid() ? peer->get_connection_status() : MultiplayerPeer::CONNECTION_DISCONNECTED;
@@ -295,5 +493,8 @@ void RollbackMultiplayer::_update_rollback_state() {
 		rollback_state = ROLLBACK_STATE_OFFLINE;
 	}
 
-	last_rollback_state = rollback_state;
+	if (rollback_state != last_rollback_state) {
+		last_rollback_state = rollback_state;
+		_rollback_state_changed();
+	}
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "clock_estimator.h"
 #include "input_replica_interface.h"
+#include "timer_wheel.h"
 #include "tinystuff.h"
 
 #include "modules/multiplayer/scene_multiplayer.h"
@@ -9,6 +11,8 @@
 class RollbackMultiplayer : public SceneMultiplayer {
 	GDCLASS(RollbackMultiplayer, SceneMultiplayer);
 
+	friend class InputReplicaInterface;
+
 public:
 	enum RollbackState {
 		ROLLBACK_STATE_OFFLINE,
@@ -19,33 +23,65 @@ public:
 private:
 	Ref<InputReplicaInterface> input_replication;
 
-	struct PingSample {
-		struct PingSampleSorter {
-			_ALWAYS_INLINE_ bool operator()(const PingSample &l, const PingSample &r) const {
-				return l.get_rtt() < r.get_rtt();
-			}
-		};
-
-		double ping_sent = 0;
-		double ping_received = 0; // time at which the server have received the ping, same as pong_sent
-		double pong_sent = 0;
-		double pong_received = 0;
-
-		double get_rtt() const {
-			return (pong_received - ping_sent);
-		}
-
-		double get_offset() const {
-			return ((ping_received - ping_sent) + (pong_sent - pong_received)) / 2.0;
-		}
+	static constexpr double PING_INTERVAL_MIN = 0.5;
+	static constexpr double PING_INTERVAL_MAX = 4.0; // once the clock estimate is confident
+
+	// connect-time burst, the clock is set from the best samples before the simulation starts
+	static constexpr uint32_t BOOTSTRAP_PINGS = 8;
+	static constexpr double BOOTSTRAP_INTERVAL = 0.02;
+	static constexpr double BOOTSTRAP_TIMEOUT = 1.0; // wait for late pongs, then settle with what we have
+
+	bool clock_synchronized = false;
+	uint32_t bootstrap_sent = 0;
+	uint32_t bootstrap_received = 0;
+	double bootstrap_last_sent = 0;
+	// server tick and clock of the lowest RTT pong of the burst
+	double bootstrap_best_rtt = 0;
+	uint64_t bootstrap_server_tick = 0;
+	double bootstrap_server_time = 0;
+	void _bootstrap_clock();
+	void _finish_bootstrap();
+
+	double ping_interval = PING_INTERVAL_MIN;
+	TimerWheel::TimerID ping_timer = 0;
+	void _ping_timeout();
+	void _set_ping_interval(double p_interval);
+
+	uint32_t sample_index = 0;
+	HashMap<uint32_t, ClockEstimator::Sample> awaiting_samples;
+	ClockEstimator clock_estimator;
+	double last_sample_time = 0;
+	void _add_clock_sample(const ClockEstimator::Sample &p_sample);
+	void _adjust_clock(bool p_accepted);
+
+	static constexpr double PIGGYBACK_WINDOW = 0.1;
+	ClockEstimator::Sample piggyback_sample;
+	double piggyback_window_start = 0;
+	bool piggyback_pending = false;
+	void _piggyback_clock_sample(const ClockEstimator::Sample &p_sample);
+	void _slew_clock();
+
+	// server side, how early the inputs of each client arrive, in ticks before they are replayed
+	struct PeerTiming {
+		double lead_mean = 0;
+		double lead_variance = 0;
+		uint64_t late_count = 0;
+		uint64_t samples = 0;
+		int target_depth = 0; // jitter buffer target of the input, the lead converges on it
+
+		// ticks the client should move its lead by, positive to speed up
+		double get_lead_hint() const;
 	};
 
-	MicroTimer ping_timer = { 0.5 };
+	static constexpr double LEAD_SMOOTHING = 1.0 / 16.0;
+	static constexpr double LEAD_SAFETY = 1.0; // minimum lead, in ticks
+	static constexpr double LEAD_MAX = 0.25; // seconds, client side
+	static constexpr double LEAD_GAIN = 0.02; // acks arrive every network tick, the server average lags behind
 
-	uint32_t sample_index = 0;
-	HashMap<uint32_t, PingSample> awaiting_samples;
-	FixedBuffer<PingSample> sample_buffer{ 8 };
-	void _adjust_clock();
+	HashMap<int, PeerTiming> peer_timings;
+	void _track_input_lead(int p_peer, int64_t p_lead, int p_target_depth);
+	void _apply_lead_hint(double p_hint);
+	void _peer_disconnected(int p_peer);
 
 	RollbackState rollback_state = ROLLBACK_STATE_OFFLINE;
 	RollbackState last_rollback_state = ROLLBACK_STATE_OFFLINE;
@@ -53,6 +89,7 @@ private:
 	PackedByteArray packet_cache;
 
 	void _update_rollback_state();
+	void _rollback_state_changed();
 
 	enum {
 		CMD_FLAG_PING_PONG_SHIFT = 1 << SceneMultiplayer::CMD_FLAG_0_SHIFT,
@@ -61,6 +98,7 @@ private:
 	enum {
 		COMMAND_PING,
 		COMMAND_PONG,
+		COMMAND_INPUT_ACK, // see InputReplicaInterface
 	};
 
 	Error ping(); // ping the server
@@ -74,6 +112,8 @@ protected:
 
 public:
 	RollbackState get_rollback_state() const { return rollback_state; }
+	bool is_clock_synchronized() const { return clock_synchronized; }
+	Dictionary get_peer_timing(int p_peer) const;
 
 	virtual void set_multiplayer_peer(const Ref<MultiplayerPeer> &p_peer) override;
 
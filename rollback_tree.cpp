@@ -9,6 +9,7 @@
 void RollbackTree::initialize() {
 	SceneTree::initialize();
 
+	FrameTime::sample();
 	Network::get_singleton()->reset_time();
 
 	Network::get_singleton()->_in_rollback = false;
@@ -39,11 +40,22 @@ int RollbackTree::get_override_physics_steps() {
 	const int physics_ticks_per_second = Engine::get_singleton()->get_physics_ticks_per_second();
 	const double physics_step = 1.0 / physics_ticks_per_second;
 
+	// a single clock read, both clocks step from the same "now"
+	FrameTime::sample();
+
+	// clients hold the simulation until the clock bootstrap is done, the simulation clock is set in RollbackMultiplayer::_finish_bootstrap
+	RollbackMultiplayer *rm = Object::cast_to<RollbackMultiplayer>(get_multiplayer().ptr());
+	if (rm && rm->get_rollback_state() == RollbackMultiplayer::ROLLBACK_STATE_CLIENT && !rm->is_clock_synchronized()) {
+		Network::get_singleton()->_simulation_clock_ptr->steps = 0;
+		return 0;
+	}
+
 	Network::get_singleton()->_simulation_clock_ptr->step();
 	Network::get_singleton()->_simulation_clock_ptr->advance(physics_step, max_physics_steps);
 
 	// pretend the simulation run faster/slower to catch up
-	Network::get_singleton()->_simulation_clock_ptr->adjust_towards(Network::get_singleton()->_reference_clock_ptr->get_time(), physics_step);
+	// clients aim ahead of the server by the lead it asks for, so inputs arrive just in time
+	Network::get_singleton()->_simulation_clock_ptr->adjust_towards(Network::get_singleton()->_reference_clock_ptr->get_time() + Network::get_singleton()->_input_lead, physics_step);
 
 	return Network::get_singleton()->_simulation_clock_ptr->steps;
 }
@@ -56,6 +68,9 @@ void RollbackTree::iteration_prepare() {
 	// network frames increases by a fixed delta, regardless of wall time
 	Network::get_singleton()->_in_rollback = false;
 	Network::get_singleton()->_network_frames++;
+	Network::get_singleton()->_update_network_tick();
+
+	Network::get_singleton()->timer_wheel.advance(FrameTime::sample());
 
 	// TODO: I do not like this cast here...
 	RollbackMultiplayer *rm = Object::cast_to<RollbackMultiplayer>(get_multiplayer().ptr());
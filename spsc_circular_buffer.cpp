@@ -0,0 +1,45 @@
+#include "spsc_circular_buffer.h"
+
+void SPSCCircularBuffer::resize(const int p_capacity) {
+	ERR_FAIL_COND(p_capacity < 0);
+	ERR_FAIL_COND_MSG(in_use.load(std::memory_order_acquire), "Cannot resize a SPSCCircularBuffer after it has been pushed to or popped from.");
+	ring.resize(p_capacity);
+}
+
+bool SPSCCircularBuffer::push(const Variant &p_value) {
+	in_use.store(true, std::memory_order_release);
+	return ring.push(p_value);
+}
+
+Variant SPSCCircularBuffer::pop() {
+	in_use.store(true, std::memory_order_release);
+	Variant value;
+	ring.pop(value);
+	return value;
+}
+
+Array SPSCCircularBuffer::pop_all() {
+	in_use.store(true, std::memory_order_release);
+	Array result;
+	// Only drain what is there now, the producer may keep pushing meanwhile
+	const int count = ring.size();
+	result.resize(count);
+
+	Variant value;
+	for (int i = 0; i < count && ring.pop(value); i++) {
+		result.set(i, value);
+	}
+	return result;
+}
+
+void SPSCCircularBuffer::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("is_empty"), &SPSCCircularBuffer::is_empty);
+	ClassDB::bind_method(D_METHOD("capacity"), &SPSCCircularBuffer::capacity);
+	ClassDB::bind_method(D_METHOD("size"), &SPSCCircularBuffer::size);
+
+	ClassDB::bind_method(D_METHOD("resize", "capacity"), &SPSCCircularBuffer::resize);
+
+	ClassDB::bind_method(D_METHOD("push", "value"), &SPSCCircularBuffer::push);
+	ClassDB::bind_method(D_METHOD("pop"), &SPSCCircularBuffer::pop);
+	ClassDB::bind_method(D_METHOD("pop_all"), &SPSCCircularBuffer::pop_all);
+}
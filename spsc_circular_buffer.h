@@ -0,0 +1,136 @@
+#pragma once
+
+#include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+#include <atomic>
+
+/**
+ * Lock-free single-producer/single-consumer ring.
+ *
+ * One thread pushes, another one pops, neither blocks. The capacity is
+ * rounded up to a power of two so positions wrap with a mask. Head and tail
+ * are fenced by a full cache line of padding on both sides, so they never
+ * share a line with each other or with the neighbouring members, whatever the
+ * alignment the allocator gives. Each side also caches the last index it read
+ * from the other side to avoid bouncing the line on every call.
+ *
+ * resize() and clear() are not thread safe, call them before handing the
+ * ring to the producer.
+ */
+template <typename T>
+class SPSCRing {
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+
+	// memnew only aligns to max_align_t, alignas would not hold, whole lines of padding do
+	uint8_t _pad0[CACHE_LINE_SIZE];
+
+	// Producer side
+	std::atomic<uint32_t> _head = 0;
+	uint32_t _cached_tail = 0;
+	uint8_t _pad1[CACHE_LINE_SIZE];
+
+	// Consumer side
+	std::atomic<uint32_t> _tail = 0;
+	uint32_t _cached_head = 0;
+	uint8_t _pad2[CACHE_LINE_SIZE];
+
+	// Shared, read only once configured
+	LocalVector<T> data;
+	uint32_t mask = 0;
+
+public:
+	_FORCE_INLINE_ uint32_t capacity() const { return data.size(); }
+
+	// Safe from any thread, approximate when called while the other side is running.
+	// The tail is loaded first, the head can only move past it, never behind, so the difference cannot wrap.
+	// The tail may advance between the two loads, the result is clamped to the capacity.
+	_FORCE_INLINE_ uint32_t size() const {
+		const uint32_t tail = _tail.load(std::memory_order_acquire);
+		const uint32_t head = _head.load(std::memory_order_acquire);
+		return MIN(head - tail, (uint32_t)data.size());
+	}
+
+	_FORCE_INLINE_ bool is_empty() const { return size() == 0; }
+
+	void resize(uint32_t p_capacity) {
+		p_capacity = p_capacity > 0 ? next_power_of_2(p_capacity) : 0;
+		data.resize(p_capacity);
+		for (uint32_t i = 0; i < p_capacity; i++) {
+			data[i] = T();
+		}
+		mask = p_capacity > 0 ? p_capacity - 1 : 0;
+		clear();
+	}
+
+	void clear() {
+		_head.store(0, std::memory_order_relaxed);
+		_tail.store(0, std::memory_order_relaxed);
+		_cached_tail = 0;
+		_cached_head = 0;
+	}
+
+	// Producer only, returns false if the ring is full.
+	bool push(const T &p_value) {
+		const uint32_t head = _head.load(std::memory_order_relaxed);
+		if (head - _cached_tail == data.size()) {
+			_cached_tail = _tail.load(std::memory_order_acquire);
+			if (head - _cached_tail == data.size()) {
+				return false;
+			}
+		}
+
+		data[head & mask] = p_value;
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer only, returns false if the ring is empty.
+	bool pop(T &r_value) {
+		const uint32_t tail = _tail.load(std::memory_order_relaxed);
+		if (tail == _cached_head) {
+			_cached_head = _head.load(std::memory_order_acquire);
+			if (tail == _cached_head) {
+				return false;
+			}
+		}
+
+		T &slot = data[tail & mask];
+		r_value = std::move(slot);
+		slot = T(); // do not keep references alive in the slot
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	SPSCRing() {}
+	SPSCRing(uint32_t p_capacity) { resize(p_capacity); }
+};
+
+// Scriptable SPSC ring of Variants, see SPSCRing.
+// Scripts size it once, before the first push or pop, the ring is never reconfigured while a thread uses it.
+class SPSCCircularBuffer : public RefCounted {
+	GDCLASS(SPSCCircularBuffer, RefCounted)
+
+private:
+	SPSCRing<Variant> ring;
+	std::atomic<bool> in_use = false; // set by the first push or pop
+
+protected:
+	static void _bind_methods();
+
+public:
+	SPSCRing<Variant> &get_ring() { return ring; }
+
+	bool is_empty() const { return ring.is_empty(); }
+	int capacity() const { return ring.capacity(); }
+	int size() const { return ring.size(); }
+
+	void resize(const int p_capacity);
+
+	bool push(const Variant &p_value);
+	Variant pop();
+	Array pop_all();
+
+	SPSCCircularBuffer() = default;
+};
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "modules/voidine_sdk/circular_buffer.h"
+
+#include "core/os/os.h"
+#include "tests/test_macros.h"
+
+namespace TestCircularBuffer {
+
+TEST_CASE("[Modules][CircularBuffer] Modulo and mask indexing agree") {
+	CircularStorage<int> modulo;
+	modulo.resize(16);
+	CircularStorage<int> mask;
+	mask.set_power_of_two(true);
+	mask.resize(16);
+
+	for (int i = 0; i < 40; i++) {
+		modulo.append(i);
+		mask.append(i);
+	}
+
+	REQUIRE(modulo.size() == mask.size());
+	for (int i = -modulo.size(); i < modulo.size(); i++) {
+		CHECK(modulo.at(i) == mask.at(i));
+	}
+
+	Vector<int> a;
+	Vector<int> b;
+	modulo.slice(a, 3, 14, 2);
+	mask.slice(b, 3, 14, 2);
+	CHECK(a == b);
+	modulo.slice(a, -1, -16, -3);
+	mask.slice(b, -1, -16, -3);
+	CHECK(a == b);
+
+	// wraps at a different place every round
+	for (int r = 0; r < 8; r++) {
+		for (int i = 0; i < 16 + 16 / 3; i++) {
+			modulo.append(r * 16 + i);
+			mask.append(r * 16 + i);
+		}
+		for (int i = 0; i < modulo.size(); i++) {
+			CHECK(modulo.at(i) == mask.at(i));
+		}
+		modulo.slice(a, r % 7, modulo.size(), 1 + r % 3);
+		mask.slice(b, r % 7, mask.size(), 1 + r % 3);
+		CHECK(a == b);
+	}
+}
+
+// the statistics of the window computed the slow way, oldest first
+template <typename T>
+static void _check_stats(const CircularStatsStorage<T> &p_storage) {
+	REQUIRE(p_storage.size() > 0);
+
+	LocalVector<T> values;
+	typename CircularStatsStorage<T>::Sum sum = 0;
+	for (int i = 0; i < p_storage.size(); i++) {
+		values.push_back(p_storage.at(i));
+		sum += values[i];
+	}
+	values.sort();
+
+	CHECK(p_storage.sum() == doctest::Approx(sum));
+	CHECK(p_storage.mean() == doctest::Approx(double(sum) / double(values.size())));
+	CHECK(p_storage.min() == values[0]);
+	CHECK(p_storage.max() == values[values.size() - 1]);
+	CHECK(p_storage.percentile(0.0) == values[0]);
+	CHECK(p_storage.percentile(0.5) == values[(int)Math::round(0.5 * (values.size() - 1))]);
+	CHECK(p_storage.percentile(1.0) == values[values.size() - 1]);
+}
+
+TEST_CASE("[Modules][CircularBuffer] Windowed statistics follow the window") {
+	CircularStatsStorage<int64_t> storage;
+	storage.resize(8);
+
+	// a zigzag with a slow trend, the extremes leave the window from both queues
+	for (int i = 0; i < 40; i++) {
+		storage.append((i % 5) * 10 - i);
+		_check_stats(storage);
+	}
+
+	SUBCASE("Decreasing then increasing runs") {
+		for (int i = 0; i < 12; i++) {
+			storage.append(100 - i);
+			_check_stats(storage);
+		}
+		for (int i = 0; i < 12; i++) {
+			storage.append(i);
+			_check_stats(storage);
+		}
+	}
+
+	SUBCASE("Popping the oldest") {
+		while (storage.size() > 1) {
+			storage.pop_front();
+			_check_stats(storage);
+		}
+	}
+
+	SUBCASE("Set in place") {
+		storage.array_set(3, 1000);
+		_check_stats(storage);
+		storage.array_set(3, -1000);
+		_check_stats(storage);
+		storage.append(5);
+		_check_stats(storage);
+	}
+
+	SUBCASE("Resize") {
+		storage.resize(5);
+		CHECK(storage.sum() == 0);
+		CHECK(storage.mean() == 0.0);
+		for (int i = 0; i < 13; i++) {
+			storage.append(i * 7 % 11);
+			_check_stats(storage);
+		}
+	}
+
+	SUBCASE("Power of two mode") {
+		storage.set_power_of_two(true);
+		for (int i = 0; i < 20; i++) {
+			storage.append(i * 7 % 11);
+			_check_stats(storage);
+		}
+	}
+}
+
+TEST_CASE("[Modules][CircularBuffer] Float sum does not drift") {
+	CircularStatsStorage<float> storage;
+	storage.resize(16);
+	storage.sum(); // tracked from here on, appends update the running sum
+
+	// large values leaving the window cancel out poorly against the small ones
+	for (int i = 0; i < 16 * 1000; i++) {
+		storage.append(i % 3 == 0 ? 1.0e7f : 0.1f);
+	}
+	REQUIRE(storage.head() == 0); // just wrapped
+
+	double sum = 0;
+	for (int i = 0; i < storage.size(); i++) {
+		sum += storage.at(i);
+	}
+	CHECK(storage.sum() == sum);
+	_check_stats(storage);
+}
+
+static constexpr int BENCHMARK_CAPACITY = 1024; // a power of two, both modes keep the same capacity
+static constexpr int BENCHMARK_ROUNDS = 200;
+
+struct IndexingTimings {
+	uint64_t append = 0;
+	uint64_t at = 0;
+	uint64_t slice = 0;
+	int64_t checksum = 0; // the same in both modes, keeps the reads from being optimized out
+};
+
+static IndexingTimings _run_indexing(bool p_power_of_two) {
+	CircularStorage<int64_t> storage;
+	storage.set_power_of_two(p_power_of_two);
+	storage.resize(BENCHMARK_CAPACITY);
+
+	IndexingTimings timings;
+	Vector<int64_t> sliced;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < BENCHMARK_ROUNDS; r++) {
+		for (int i = 0; i < BENCHMARK_CAPACITY + BENCHMARK_CAPACITY / 3; i++) { // wraps at a different place every round
+			storage.append(int64_t(r) * BENCHMARK_CAPACITY + i);
+		}
+	}
+	timings.append = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < BENCHMARK_ROUNDS; r++) {
+		for (int i = 0; i < storage.size(); i++) {
+			timings.checksum += storage.at(i) ^ i;
+		}
+	}
+	timings.at = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < BENCHMARK_ROUNDS; r++) {
+		storage.slice(sliced, r % 7, storage.size(), 1 + r % 3);
+		timings.checksum += sliced[sliced.size() - 1];
+	}
+	timings.slice = OS::get_singleton()->get_ticks_usec() - begin;
+
+	return timings;
+}
+
+// a benchmark, skipped by default, run it with --no-skip, the timings are printed and never checked
+TEST_CASE("[Modules][CircularBuffer][Benchmark] Modulo against mask indexing" * doctest::skip()) {
+	_run_indexing(true); // warm up
+
+	const IndexingTimings modulo = _run_indexing(false);
+	const IndexingTimings mask = _run_indexing(true);
+
+	CHECK(modulo.checksum == mask.checksum);
+
+	MESSAGE(vformat("append: modulo %d usec, mask %d usec", modulo.append, mask.append));
+	MESSAGE(vformat("at: modulo %d usec, mask %d usec", modulo.at, mask.at));
+	MESSAGE(vformat("slice: modulo %d usec, mask %d usec", modulo.slice, mask.slice));
+}
+
+} // namespace TestCircularBuffer
@@ -0,0 +1,357 @@
+#pragma once
+
+#include "modules/voidine_sdk/input_frame_codec.h"
+#include "modules/voidine_sdk/input_replica_interface.h"
+#include "modules/voidine_sdk/input_schema.h"
+#include "modules/voidine_sdk/network_input.h"
+#include "modules/voidine_sdk/network_input_replica_config.h"
+#include "modules/voidine_sdk/rollback_multiplayer.h"
+
+#include "core/io/marshalls.h"
+#include "core/os/os.h"
+#include "scene/2d/node_2d.h"
+#include "scene/main/window.h"
+#include "tests/test_macros.h"
+
+namespace TestInputReplica {
+
+// the input replica sends this many frames per section at most
+static constexpr int WINDOW = 8;
+
+// a ring of rows as NetworkInput keeps it, encoded and decoded the way a section travels
+struct SendPath {
+	InputSchema schema;
+	LocalVector<Variant> rows;
+	LocalVector<InputFrame> frames;
+	LocalVector<uint8_t> packet;
+
+	LocalVector<Variant> decoded_values;
+	LocalVector<InputFrame> decoded_frames;
+
+	void write(uint64_t p_frame_id, Node2D *p_source) {
+		const int slots = schema.size();
+		Variant *row = rows.ptr() + (p_frame_id % WINDOW) * slots;
+		for (int i = 0; i < slots; i++) {
+			row[i] = p_source->get_indexed(schema.get_slot(i).path.get_names());
+			schema.snap(i, row[i]);
+		}
+	}
+
+	Error send(uint64_t p_newest) {
+		const int slots = schema.size();
+		frames.clear();
+		for (uint64_t id = p_newest - WINDOW + 1; id <= p_newest; id++) {
+			InputFrame frame;
+			frame.frame_id = id;
+			frame.values = Span<Variant>(rows.ptr() + (id % WINDOW) * slots, slots);
+			frames.push_back(frame);
+		}
+
+		int size = 0;
+		Error err = InputFrameCodec::encode(schema, frames.ptr(), frames.size(), packet, 15, size); // behind a packet and a section header
+		if (err != OK) {
+			return err;
+		}
+		return InputFrameCodec::decode(schema, frames.size(), packet.ptr() + 15, size, decoded_values, decoded_frames);
+	}
+};
+
+TEST_CASE("[Modules][InputReplica] Frames round trip through the codec") {
+	Node2D *source = memnew(Node2D);
+	Ref<NetworkInputReplicaConfig> config;
+	config.instantiate();
+	config->add_property(NodePath("position"));
+	config->add_property(NodePath("z_index"));
+	config->add_property(NodePath("visible"));
+	config->add_property(NodePath("modulate")); // generic encoder
+
+	SendPath path;
+	REQUIRE(path.schema.compile(config, source) == OK);
+	path.rows.resize(WINDOW * path.schema.size());
+
+	for (uint64_t id = 1; id <= WINDOW; id++) {
+		source->set_position(Vector2(id, -int(id)));
+		source->set_z_index(id % 3);
+		source->set_modulate(Color(0, 0, 0, id % 2));
+		path.write(id, source);
+	}
+
+	REQUIRE(path.send(WINDOW) == OK);
+	REQUIRE(path.decoded_frames.size() == WINDOW);
+	for (uint32_t i = 0; i < path.decoded_frames.size(); i++) {
+		const InputFrame &frame = path.decoded_frames[i];
+		CHECK(frame.frame_id == i + 1);
+		for (int j = 0; j < path.schema.size(); j++) {
+			CHECK(frame.values[j] == path.frames[i].values[j]);
+		}
+	}
+
+	memdelete(source);
+}
+
+TEST_CASE("[Modules][InputReplica] Properties that cannot be replicated are rejected on compile") {
+	Node2D *source = memnew(Node2D);
+	Ref<NetworkInputReplicaConfig> config;
+	config.instantiate();
+	config->add_property(NodePath("position"));
+	config->add_property(NodePath("material")); // an object
+
+	InputSchema schema;
+	ERR_PRINT_OFF;
+	CHECK(schema.compile(config, source) == ERR_INVALID_DATA);
+	ERR_PRINT_ON;
+	CHECK(schema.is_empty()); // no partial layout
+
+	memdelete(source);
+}
+
+// the interface as the client runs it, the packets stop here instead of reaching a peer
+class SendSink : public InputReplicaInterface {
+	GDSOFTCLASS(SendSink, InputReplicaInterface);
+
+public:
+	const uint8_t *last_packet = nullptr;
+	int last_size = 0;
+	int packets = 0;
+
+	Error send_local_inputs() { return _send_local_inputs(); }
+
+	virtual Error _send_raw(const uint8_t *p_buffer, int p_size, int p_peer, bool p_reliable) override {
+		last_packet = p_buffer;
+		last_size = p_size;
+		packets++;
+		return OK;
+	}
+
+	SendSink(RollbackMultiplayer *p_multiplayer) :
+			InputReplicaInterface(p_multiplayer) {}
+};
+
+TEST_CASE("[SceneTree][Modules][InputReplica] Steady state sends do not allocate") {
+	const NodePath priority("process_priority");
+
+	Ref<NetworkInputReplicaConfig> config;
+	config.instantiate();
+	config->add_property(priority);
+	config->add_property(NodePath("process_physics_priority"));
+
+	Ref<RollbackMultiplayer> multiplayer;
+	multiplayer.instantiate();
+
+	Ref<SendSink> sink = memnew(SendSink(multiplayer.ptr()));
+	sink->rebuild_inputs();
+
+	// local inputs, the offline peer has the authority, they all go in one packet
+	LocalVector<NetworkInput *> inputs;
+	for (int i = 0; i < 3; i++) {
+		NetworkInput *input = memnew(NetworkInput);
+		input->set_name(vformat("LocalInput%d", i));
+		input->set_replica_config(config);
+		SceneTree::get_singleton()->get_root()->add_child(input);
+		REQUIRE(input->is_multiplayer_authority());
+		REQUIRE(sink->add_input(input, input) == OK);
+		inputs.push_back(input);
+	}
+
+	// sampled, gathered into the ring of each input, read back in place and encoded
+	int64_t id = 0;
+	const auto tick = [&]() {
+		id++;
+		for (uint32_t i = 0; i < inputs.size(); i++) {
+			inputs[i]->sample(priority, id % 7 + i);
+			inputs[i]->sample(priority, id % 5);
+			inputs[i]->set_process_physics_priority(int(id % 3));
+		}
+		sink->capture_inputs();
+		return sink->send_local_inputs();
+	};
+
+	// grows the scratch to its steady size, no acks so every section holds the most frames a packet carries
+	for (int i = 0; i < 256; i++) {
+		REQUIRE(tick() == OK);
+	}
+	REQUIRE(sink->packets == 256);
+	REQUIRE(sink->last_size > 0);
+
+	// counted in debug builds, where every allocation goes through Memory
+	const uint64_t usage = Memory::get_mem_usage();
+	const uint8_t *packet = sink->last_packet;
+
+	for (int i = 0; i < 1000; i++) {
+		REQUIRE(tick() == OK);
+		CHECK_MESSAGE(Memory::get_mem_usage() == usage, "The send path allocated.");
+	}
+	CHECK(sink->packets == 1256);
+
+	// a reallocation frees the old block, the usage alone would not show it
+	CHECK(sink->last_packet == packet);
+
+	for (NetworkInput *input : inputs) {
+		sink->remove_input(input, input);
+		memdelete(input);
+	}
+}
+
+// one input packet as the client sends it, a single section with a single frame
+static void _write_input_packet(LocalVector<uint8_t> &r_packet, NetworkInput *p_input, uint64_t p_frame_id, uint16_t p_sequence) {
+	static constexpr int HEADER_SIZE = 8;
+	static constexpr int SECTION_HEADER_SIZE = 7;
+
+	const Variant value = int64_t(p_frame_id % 5);
+	InputFrame frame;
+	frame.frame_id = p_frame_id;
+	frame.values = Span<Variant>(&value, 1);
+
+	int size = 0;
+	REQUIRE(InputFrameCodec::encode(p_input->get_schema(), &frame, 1, r_packet, HEADER_SIZE + SECTION_HEADER_SIZE, size) == OK);
+
+	uint8_t *ptr = r_packet.ptr();
+	ptr[0] = SceneMultiplayer::NETWORK_COMMAND_RAW | 1 << SceneMultiplayer::CMD_FLAG_1_SHIFT;
+	ptr[1] = 1;
+	encode_uint32(0, &ptr[2]);
+	encode_uint16(p_sequence, &ptr[6]);
+	encode_uint32(p_input->get_input_id(), &ptr[HEADER_SIZE]);
+	ptr[HEADER_SIZE + 4] = 1;
+	encode_uint16(uint16_t(size), &ptr[HEADER_SIZE + 5]);
+}
+
+// every tracked input is routed from its authority, and nothing else is
+static void _check_routing(InputReplicaInterface *p_routing, const LocalVector<NetworkInput *> &p_tracked, int p_peers) {
+	LocalVector<NetworkInput *> routed;
+	for (int peer = 2; peer < 2 + p_peers; peer++) {
+		p_routing->get_peer_inputs(peer, routed);
+
+		uint32_t owned = 0;
+		for (NetworkInput *input : p_tracked) {
+			if (input->get_multiplayer_authority() == peer) {
+				owned++;
+				CHECK_MESSAGE(routed.has(input), vformat("%s is not routed from peer %d.", input->get_name(), peer));
+			}
+		}
+		CHECK(routed.size() == owned);
+	}
+}
+
+// sends one packet per tracked input, every packet must land on its own input
+static void _route_round(InputReplicaInterface *p_routing, const LocalVector<NetworkInput *> &p_tracked, uint64_t p_frame_id) {
+	LocalVector<uint8_t> packet;
+	for (NetworkInput *input : p_tracked) {
+		_write_input_packet(packet, input, p_frame_id, uint16_t(p_frame_id));
+		p_routing->process_inputs(input->get_multiplayer_authority(), packet.ptr(), packet.size());
+	}
+	for (NetworkInput *input : p_tracked) {
+		CHECK(uint64_t(input->get_current_frame()) == p_frame_id);
+	}
+}
+
+TEST_CASE("[SceneTree][Modules][InputReplica] Packets are routed to the inputs of their peer") {
+	static constexpr int PEERS = 8;
+
+	Ref<NetworkInputReplicaConfig> config;
+	config.instantiate();
+	config->add_property(NodePath("process_priority"));
+
+	Ref<RollbackMultiplayer> multiplayer;
+	multiplayer.instantiate(); // offline, the server
+
+	Ref<InputReplicaInterface> routing = memnew(InputReplicaInterface(multiplayer.ptr()));
+	routing->rebuild_inputs();
+
+	// two inputs per peer, the routing picks the right one by input id
+	LocalVector<NetworkInput *> inputs;
+	for (int i = 0; i < PEERS * 2; i++) {
+		NetworkInput *input = memnew(NetworkInput);
+		input->set_name(vformat("Input%d", i));
+		input->set_replica_config(config);
+		if (i % 2 == 0) {
+			input->set_multiplayer_authority(2 + i / 2); // before entering the tree, the usual spawn order
+		}
+		SceneTree::get_singleton()->get_root()->add_child(input);
+		if (i % 2 == 1) {
+			input->set_multiplayer_authority(2 + i / 2);
+		}
+		REQUIRE(routing->add_input(input, input) == OK);
+		inputs.push_back(input);
+	}
+
+	LocalVector<NetworkInput *> tracked = inputs;
+	_check_routing(routing.ptr(), tracked, PEERS);
+	uint64_t frame_id = 1;
+	_route_round(routing.ptr(), tracked, frame_id++);
+
+	// the last input fills the hole of a removed one
+	for (int i = 0; i < PEERS * 2; i += 3) {
+		routing->remove_input(inputs[i], inputs[i]);
+		tracked.erase(inputs[i]);
+	}
+	_check_routing(routing.ptr(), tracked, PEERS);
+	_route_round(routing.ptr(), tracked, frame_id++);
+
+	// a new authority, the records are resolved again
+	tracked[0]->set_multiplayer_authority(2 + PEERS - 1);
+	tracked[1]->set_multiplayer_authority(2);
+	routing->rebuild_inputs();
+	_check_routing(routing.ptr(), tracked, PEERS);
+	_route_round(routing.ptr(), tracked, frame_id++);
+
+	for (NetworkInput *input : inputs) {
+		routing->remove_input(input, input);
+		memdelete(input);
+	}
+	_check_routing(routing.ptr(), LocalVector<NetworkInput *>(), PEERS);
+}
+
+// a benchmark, skipped by default, run it with --no-skip, the timings are printed and never checked
+TEST_CASE("[SceneTree][Modules][InputReplica][Benchmark] Packet routing cost against the peers" * doctest::skip()) {
+	static constexpr int PACKETS = 256 * 60; // per run, the same for every peer count
+
+	Ref<NetworkInputReplicaConfig> config;
+	config.instantiate();
+	config->add_property(NodePath("process_priority"));
+
+	Ref<RollbackMultiplayer> multiplayer;
+	multiplayer.instantiate(); // offline, the server
+
+	for (const int peers : { 1, 16, 128 }) {
+		Ref<InputReplicaInterface> routing = memnew(InputReplicaInterface(multiplayer.ptr()));
+		routing->rebuild_inputs();
+
+		LocalVector<NetworkInput *> inputs;
+		for (int i = 0; i < peers * 2; i++) {
+			NetworkInput *input = memnew(NetworkInput);
+			input->set_name(vformat("Input%d", i));
+			input->set_replica_config(config);
+			input->set_multiplayer_authority(2 + i / 2);
+			SceneTree::get_singleton()->get_root()->add_child(input);
+			REQUIRE(routing->add_input(input, input) == OK);
+			inputs.push_back(input);
+		}
+
+		// a round is one packet per input, built ahead so only the routing is timed
+		LocalVector<LocalVector<uint8_t>> packets;
+		packets.resize(inputs.size());
+
+		const int rounds = PACKETS / inputs.size();
+		uint64_t elapsed = 0;
+		for (int r = 1; r <= rounds; r++) {
+			for (uint32_t i = 0; i < inputs.size(); i++) {
+				_write_input_packet(packets[i], inputs[i], r, r);
+			}
+
+			const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (uint32_t i = 0; i < inputs.size(); i++) {
+				routing->process_inputs(inputs[i]->get_multiplayer_authority(), packets[i].ptr(), packets[i].size());
+			}
+			elapsed += OS::get_singleton()->get_ticks_usec() - begin;
+		}
+
+		for (NetworkInput *input : inputs) {
+			routing->remove_input(input, input);
+			memdelete(input);
+		}
+
+		MESSAGE(vformat("%d peers: %.3f usec per packet", peers, double(elapsed) / double(rounds * inputs.size())));
+	}
+}
+
+} // namespace TestInputReplica
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "modules/voidine_sdk/spsc_circular_buffer.h"
+
+#include "core/os/thread.h"
+#include "tests/test_macros.h"
+
+namespace TestSPSCCircularBuffer {
+
+TEST_CASE("[Modules][SPSCCircularBuffer] Push and pop") {
+	SPSCRing<int> ring;
+	ring.resize(5);
+	CHECK(ring.capacity() == 8); // rounded up to a power of two
+	CHECK(ring.is_empty());
+
+	int value = -1;
+	CHECK_FALSE(ring.pop(value));
+	CHECK(value == -1);
+
+	for (int i = 0; i < 8; i++) {
+		CHECK(ring.push(i));
+	}
+	CHECK(ring.size() == 8);
+	CHECK_FALSE(ring.push(8)); // full, nothing is overwritten
+	CHECK(ring.size() == 8);
+
+	for (int i = 0; i < 8; i++) {
+		REQUIRE(ring.pop(value));
+		CHECK(value == i);
+	}
+	CHECK(ring.is_empty());
+	CHECK_FALSE(ring.pop(value));
+
+	// positions keep going past the capacity and wrap with the mask
+	for (int i = 0; i < 100; i++) {
+		CHECK(ring.push(i));
+		CHECK(ring.push(i + 1000));
+		REQUIRE(ring.pop(value));
+		CHECK(value == i);
+		REQUIRE(ring.pop(value));
+		CHECK(value == i + 1000);
+	}
+	CHECK(ring.is_empty());
+
+	ring.push(1);
+	ring.resize(16);
+	CHECK(ring.capacity() == 16);
+	CHECK(ring.is_empty());
+}
+
+TEST_CASE("[Modules][SPSCCircularBuffer] Script API") {
+	Ref<SPSCCircularBuffer> buffer;
+	buffer.instantiate();
+	buffer->resize(3);
+	CHECK(buffer->capacity() == 4);
+
+	CHECK(buffer->pop() == Variant()); // empty
+
+	for (int i = 0; i < 4; i++) {
+		CHECK(buffer->push(i));
+	}
+	CHECK_FALSE(buffer->push(4));
+
+	CHECK(buffer->pop() == Variant(0));
+
+	const Array all = buffer->pop_all();
+	REQUIRE(all.size() == 3);
+	for (int i = 0; i < 3; i++) {
+		CHECK(all[i] == Variant(i + 1));
+	}
+	CHECK(buffer->is_empty());
+	CHECK(buffer->pop_all().is_empty());
+
+	// in use, a resize could race with the other thread
+	ERR_PRINT_OFF;
+	buffer->resize(64);
+	ERR_PRINT_ON;
+	CHECK(buffer->capacity() == 4);
+}
+
+TEST_CASE("[Modules][SPSCCircularBuffer] Resizing a buffer in use fails") {
+	Ref<SPSCCircularBuffer> buffer;
+	buffer.instantiate();
+	buffer->resize(8);
+	buffer->resize(16); // not used yet
+	CHECK(buffer->capacity() == 16);
+
+	SUBCASE("After a push") {
+		buffer->push(1);
+	}
+	SUBCASE("After a pop") {
+		buffer->pop();
+	}
+	SUBCASE("After a pop_all") {
+		buffer->pop_all();
+	}
+
+	ERR_PRINT_OFF;
+	buffer->resize(32);
+	ERR_PRINT_ON;
+	CHECK(buffer->capacity() == 16);
+}
+
+struct ProducerData {
+	SPSCRing<uint32_t> *ring = nullptr;
+	uint32_t count = 0;
+};
+
+static void _produce(void *p_userdata) {
+	ProducerData *data = static_cast<ProducerData *>(p_userdata);
+	for (uint32_t i = 0; i < data->count;) {
+		if (data->ring->push(i)) {
+			i++;
+		}
+	}
+}
+
+TEST_CASE("[Modules][SPSCCircularBuffer] Values cross threads in order") {
+	// a small ring, the producer runs into a full ring over and over
+	SPSCRing<uint32_t> ring(64);
+
+	ProducerData data;
+	data.ring = &ring;
+	data.count = 200000;
+
+	Thread producer;
+	producer.start(_produce, &data);
+
+	uint32_t expected = 0;
+	uint32_t out_of_order = 0;
+	while (expected < data.count) {
+		uint32_t value;
+		if (!ring.pop(value)) {
+			continue;
+		}
+		if (value != expected) {
+			out_of_order++;
+		}
+		expected++;
+	}
+
+	producer.wait_to_finish();
+
+	CHECK(out_of_order == 0);
+	CHECK(ring.is_empty());
+}
+
+} // namespace TestSPSCCircularBuffer
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "modules/voidine_sdk/timer_wheel.h"
+
+#include "core/math/random_pcg.h"
+#include "core/object/object.h"
+#include "tests/test_macros.h"
+
+namespace TestTimerWheel {
+
+static constexpr uint64_t MSEC = 1000; // the default resolution, one tick
+
+// records every fired timer, optionally removes another one from the callback
+class TimerProbe : public Object {
+	GDSOFTCLASS(TimerProbe, Object);
+
+public:
+	TimerWheel *wheel = nullptr;
+	LocalVector<int> fired;
+	HashMap<int, TimerWheel::TimerID> removes; // timer -> timer it removes when fired
+
+	void fire(int p_timer) {
+		fired.push_back(p_timer);
+		const TimerWheel::TimerID *id = removes.getptr(p_timer);
+		if (id) {
+			wheel->remove(*id);
+		}
+	}
+
+	Callable callback(int p_timer) {
+		return callable_mp(this, &TimerProbe::fire).bind(p_timer);
+	}
+
+	int count(int p_timer) const {
+		int n = 0;
+		for (const int timer : fired) {
+			n += timer == p_timer ? 1 : 0;
+		}
+		return n;
+	}
+};
+
+// wait time of p_ticks at the default resolution, half a tick over since the wheel truncates
+static double _wait(uint64_t p_ticks) {
+	return (p_ticks + 0.5) / 1000.0;
+}
+
+// starts away from any slot boundary, the cascades happen in the middle of the run
+static constexpr uint64_t START = 1234567;
+
+TEST_CASE("[Modules][TimerWheel] One shot timers fire on their tick at every level") {
+	TimerWheel wheel;
+	TimerProbe probe;
+	probe.wheel = &wheel;
+
+	// ticks from the start, one per level: below 2^6, 2^12, 2^18 and 2^24
+	const uint64_t delays[] = { 10, 100, 5000, 300000 };
+	for (int i = 0; i < 4; i++) {
+		REQUIRE(wheel.add(START, _wait(delays[i]), probe.callback(i), false) != 0);
+	}
+	CHECK(wheel.get_active_count() == 4);
+
+	for (int i = 0; i < 4; i++) {
+		wheel.advance(START + (delays[i] - 1) * MSEC);
+		CHECK_MESSAGE(probe.count(i) == 0, vformat("Timer %d fired early.", i));
+
+		wheel.advance(START + delays[i] * MSEC);
+		CHECK_MESSAGE(probe.count(i) == 1, vformat("Timer %d did not fire on its tick.", i));
+	}
+
+	CHECK(probe.fired.size() == 4);
+	CHECK(wheel.get_active_count() == 0);
+}
+
+TEST_CASE("[Modules][TimerWheel] Timers cascade down when a slot rolls over") {
+	TimerWheel wheel;
+	TimerProbe probe;
+	probe.wheel = &wheel;
+
+	// level one, level two, on the rollover tick of both, right after it
+	wheel.advance(60 * MSEC);
+	wheel.add(60 * MSEC, _wait(100), probe.callback(0), false); // tick 160
+	wheel.add(60 * MSEC, _wait(4100), probe.callback(1), false); // tick 4160
+	wheel.add(60 * MSEC, _wait(68), probe.callback(2), false); // tick 128, a level one rollover
+	wheel.add(60 * MSEC, _wait(4036), probe.callback(3), false); // tick 4096, a level two rollover
+	wheel.add(60 * MSEC, _wait(4037), probe.callback(4), false); // tick 4097
+
+	const uint64_t expected[] = { 160, 4160, 128, 4096, 4097 };
+	for (uint64_t tick = 61; tick <= 4200; tick++) {
+		wheel.advance(tick * MSEC);
+		for (int i = 0; i < 5; i++) {
+			CHECK(probe.count(i) == (tick >= expected[i] ? 1 : 0));
+		}
+	}
+
+	CHECK(wheel.get_active_count() == 0);
+}
+
+TEST_CASE("[Modules][TimerWheel] Timers beyond the wheel span are parked") {
+	TimerWheel wheel;
+	wheel.set_resolution(100 * MSEC); // 2^24 ticks is about 19 days
+	TimerProbe probe;
+	probe.wheel = &wheel;
+
+	const uint64_t span = uint64_t(1) << 24;
+	const uint64_t delay = span + span / 2; // ticks
+	wheel.add(0, (delay + 0.5) / 10.0, probe.callback(0), false);
+
+	wheel.advance((span - 1) * 100 * MSEC);
+	CHECK(probe.fired.is_empty());
+	wheel.advance((delay - 1) * 100 * MSEC);
+	CHECK(probe.fired.is_empty());
+	wheel.advance(delay * 100 * MSEC);
+	CHECK(probe.count(0) == 1);
+	CHECK(wheel.get_active_count() == 0);
+}
+
+TEST_CASE("[Modules][TimerWheel] Removing timers from a callback") {
+	TimerWheel wheel;
+	TimerProbe probe;
+	probe.wheel = &wheel;
+
+	SUBCASE("Another timer due on the same tick") {
+		const TimerWheel::TimerID a = wheel.add(START, _wait(10), probe.callback(0));
+		const TimerWheel::TimerID b = wheel.add(START, _wait(10), probe.callback(1));
+		probe.removes.insert(0, b);
+		probe.removes.insert(1, a);
+
+		wheel.advance(START + 10 * MSEC);
+		CHECK(probe.fired.size() == 1); // whichever fires first removes the other
+		CHECK(wheel.get_active_count() == 1);
+
+		wheel.advance(START + 100 * MSEC);
+		CHECK(probe.fired.size() == 10);
+		CHECK(probe.count(probe.fired[0]) == 10);
+	}
+
+	SUBCASE("A repeating timer removing itself") {
+		const TimerWheel::TimerID a = wheel.add(START, _wait(10), probe.callback(0));
+		probe.removes.insert(0, a);
+
+		wheel.advance(START + 10 * MSEC);
+		CHECK(probe.count(0) == 1);
+		CHECK_FALSE(wheel.has(a));
+		CHECK(wheel.get_active_count() == 0);
+
+		wheel.advance(START + 100 * MSEC);
+		CHECK(probe.count(0) == 1);
+	}
+
+	SUBCASE("A timer due later") {
+		wheel.add(START, _wait(10), probe.callback(0), false);
+		const TimerWheel::TimerID b = wheel.add(START, _wait(500), probe.callback(1), false);
+		probe.removes.insert(0, b);
+
+		wheel.advance(START + 1000 * MSEC);
+		CHECK(probe.count(0) == 1);
+		CHECK(probe.count(1) == 0);
+		CHECK(wheel.get_active_count() == 0);
+	}
+}
+
+TEST_CASE("[Modules][TimerWheel] A large advance fires a repeating timer once") {
+	TimerWheel wheel;
+	TimerProbe probe;
+	probe.wheel = &wheel;
+
+	wheel.add(START, _wait(10), probe.callback(0));
+
+	wheel.advance(START + 1000 * MSEC);
+	CHECK(probe.count(0) == 1);
+
+	wheel.advance(START + 1000 * MSEC); // the same time again
+	CHECK(probe.count(0) == 1);
+
+	// the missed intervals are skipped, the timer stays aligned to its period
+	wheel.advance(START + 1009 * MSEC);
+	CHECK(probe.count(0) == 1);
+	wheel.advance(START + 1010 * MSEC);
+	CHECK(probe.count(0) == 2);
+	wheel.advance(START + 1020 * MSEC);
+	CHECK(probe.count(0) == 3);
+}
+
+TEST_CASE("[Modules][TimerWheel] Skipping empty ticks keeps every timer on time") {
+	TimerWheel wheel;
+	TimerProbe probe;
+	probe.wheel = &wheel;
+
+	// spread over every level, some right on the next boundary of a level
+	const uint64_t start = START / MSEC;
+	RandomPCG rng(42);
+	LocalVector<uint64_t> expected;
+	for (int i = 0; i < 200; i++) {
+		uint64_t delay = 1 + rng.rand() % (i % 2 ? 300000 : 5000);
+		if (i % 10 == 0) {
+			const uint32_t shift = 6 * (1 + i / 10 % 3);
+			delay = (((start >> shift) + 1) << shift) - start;
+		}
+		wheel.add(START, _wait(delay), probe.callback(i), false);
+		expected.push_back(start + delay);
+	}
+
+	// irregular steps, from a single tick to long stalls
+	uint64_t now = start;
+	while (wheel.get_active_count() > 0) {
+		now += 1 + rng.rand() % (rng.rand() % 4 == 0 ? 20000 : 50);
+		wheel.advance(now * MSEC);
+		for (uint32_t i = 0; i < expected.size(); i++) {
+			CHECK(probe.count(i) == (expected[i] <= now ? 1 : 0));
+		}
+	}
+	CHECK(probe.fired.size() == expected.size());
+}
+
+TEST_CASE("[Modules][TimerWheel] Catching up after a stall skips the empty ticks") {
+	TimerWheel wheel;
+	TimerProbe probe;
+	probe.wheel = &wheel;
+
+	// a timer due in a day, the wheel has nothing else to do meanwhile
+	wheel.add(START, _wait(24 * 3600 * 1000), probe.callback(0), false);
+	wheel.add(START, _wait(100), probe.callback(1));
+
+	const uint64_t begin = START + 24 * 3600 * 1000 * MSEC;
+	wheel.advance(begin - MSEC);
+	CHECK(probe.count(0) == 0);
+	CHECK(probe.count(1) == 1); // repeating, fired once for the whole stall
+	wheel.advance(begin);
+	CHECK(probe.count(0) == 1);
+}
+
+} // namespace TestTimerWheel
@@ -0,0 +1,265 @@
+#include "timer_wheel.h"
+
+static _FORCE_INLINE_ uint32_t _lowest_bit(uint64_t p_bits) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(p_bits);
+#else
+	uint32_t bit = 0;
+	while ((p_bits & 1) == 0) {
+		p_bits >>= 1;
+		bit++;
+	}
+	return bit;
+#endif
+}
+
+void TimerWheel::_link(uint32_t p_index) {
+	Timer &t = timers[p_index];
+
+	// cascaded timers can be due right now, they are drained right after the cascade
+	const uint64_t expires = MAX(t.expires, current_tick);
+	uint64_t delta = expires - current_tick;
+	uint64_t slot_tick = expires;
+
+	uint32_t level = 0;
+	while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+		level++;
+	}
+
+	const uint64_t span = uint64_t(1) << (SLOT_BITS * LEVELS);
+	if (delta >= span) {
+		// farther than the wheel can see, park it in the last slot, it will be cascaded again
+		delta = span - 1;
+		slot_tick = current_tick + delta;
+	}
+
+	const uint32_t slot = level * SLOTS + ((slot_tick >> (SLOT_BITS * level)) & SLOT_MASK);
+
+	t.slot = slot;
+	t.prev = INVALID;
+	t.next = slots[slot];
+	if (t.next != INVALID) {
+		timers[t.next].prev = p_index;
+	}
+	slots[slot] = p_index;
+	occupied[level] |= uint64_t(1) << (slot & SLOT_MASK);
+}
+
+void TimerWheel::_unlink(uint32_t p_index) {
+	Timer &t = timers[p_index];
+	if (t.slot == INVALID) {
+		return;
+	}
+
+	if (t.prev != INVALID) {
+		timers[t.prev].next = t.next;
+	} else {
+		slots[t.slot] = t.next;
+		if (t.next == INVALID) {
+			occupied[t.slot / SLOTS] &= ~(uint64_t(1) << (t.slot & SLOT_MASK));
+		}
+	}
+	if (t.next != INVALID) {
+		timers[t.next].prev = t.prev;
+	}
+
+	t.slot = INVALID;
+	t.next = INVALID;
+	t.prev = INVALID;
+}
+
+void TimerWheel::_release(uint32_t p_index) {
+	_unlink(p_index);
+
+	Timer &t = timers[p_index];
+	t.callback = Callable();
+	t.generation++;
+	if (t.generation == 0) {
+		t.generation = 1;
+	}
+
+	free_list.push_back(p_index);
+	active_count--;
+}
+
+void TimerWheel::_cascade(uint32_t p_level) {
+	const uint32_t slot = p_level * SLOTS + ((current_tick >> (SLOT_BITS * p_level)) & SLOT_MASK);
+
+	uint32_t index = slots[slot];
+	slots[slot] = INVALID;
+	occupied[p_level] &= ~(uint64_t(1) << (slot & SLOT_MASK));
+	while (index != INVALID) {
+		const uint32_t next = timers[index].next;
+		timers[index].slot = INVALID;
+		_link(index);
+		index = next;
+	}
+}
+
+void TimerWheel::_expire() {
+	const uint32_t slot = current_tick & SLOT_MASK;
+
+	// callbacks may add or remove timers, always restart from the slot head
+	while (slots[slot] != INVALID) {
+		const uint32_t index = slots[slot];
+		Timer &t = timers[index];
+
+		if (t.expires > current_tick) {
+			// parked timer, not due yet
+			_unlink(index);
+			_link(index);
+			continue;
+		}
+
+		if (!t.callback.is_valid()) {
+			_release(index); // the target is gone
+			continue;
+		}
+
+		const Callable callback = t.callback;
+		if (t.interval > 0) {
+			// skip the missed intervals, fire once
+			t.expires += t.interval;
+			if (t.expires <= target_tick) {
+				t.expires += ((target_tick - t.expires) / t.interval + 1) * t.interval;
+			}
+			_unlink(index);
+			_link(index);
+		} else {
+			_release(index);
+		}
+
+		callback.call();
+	}
+}
+
+// The first tick after current_tick where a slot expires or cascades, target_tick at most.
+uint64_t TimerWheel::_next_tick() const {
+	uint64_t next = target_tick;
+	for (uint32_t level = 0; level < LEVELS; level++) {
+		const uint32_t shift = SLOT_BITS * level;
+		const uint32_t pos = (current_tick >> shift) & SLOT_MASK;
+		const uint64_t rotation = (current_tick >> (shift + SLOT_BITS)) << (shift + SLOT_BITS); // first tick of the current turn of this level
+
+		// slots ahead of the position are due within this turn
+		const uint64_t ahead = pos == SLOT_MASK ? 0 : occupied[level] & (~uint64_t(0) << (pos + 1));
+		if (ahead != 0) {
+			return MIN(next, rotation + (uint64_t(_lowest_bit(ahead)) << shift));
+		}
+
+		// the next turn starts with a cascade from the level above
+		next = MIN(next, rotation + (uint64_t(1) << (shift + SLOT_BITS)));
+
+		// slots behind the position are due in the next turn, before anything the levels above hold
+		if (occupied[level] != 0) {
+			break;
+		}
+	}
+	return next;
+}
+
+int64_t TimerWheel::_resolve(TimerID p_id) const {
+	const uint32_t index = p_id & 0xFFFFFFFF;
+	const uint32_t generation = p_id >> 32;
+	if (index >= timers.size() || timers[index].generation != generation || timers[index].slot == INVALID) {
+		return -1;
+	}
+	return index;
+}
+
+void TimerWheel::set_resolution(uint64_t p_usec) {
+	ERR_FAIL_COND(p_usec == 0);
+	ERR_FAIL_COND_MSG(active_count > 0, "Can't change the resolution while timers are scheduled.");
+	resolution_usec = p_usec;
+	started = false;
+}
+
+TimerWheel::TimerID TimerWheel::add(uint64_t p_now_usec, double p_wait_time, const Callable &p_callback, bool p_repeat) {
+	ERR_FAIL_COND_V(p_wait_time <= 0, 0);
+	ERR_FAIL_COND_V(!p_callback.is_valid(), 0);
+
+	const uint64_t now = p_now_usec / resolution_usec;
+	if (!started) {
+		current_tick = now;
+		target_tick = now;
+		started = true;
+	}
+
+	uint32_t index;
+	if (free_list.is_empty()) {
+		index = timers.size();
+		timers.push_back(Timer());
+	} else {
+		index = free_list[free_list.size() - 1];
+		free_list.remove_at(free_list.size() - 1);
+	}
+
+	const uint64_t interval = MAX(uint64_t(1), uint64_t(p_wait_time * 1000000.0 / resolution_usec));
+
+	Timer &t = timers[index];
+	t.callback = p_callback;
+	t.interval = p_repeat ? interval : 0;
+	t.expires = MAX(now, current_tick) + interval;
+	_link(index);
+	active_count++;
+
+	return (uint64_t(t.generation) << 32) | index;
+}
+
+void TimerWheel::remove(TimerID p_id) {
+	const int64_t index = _resolve(p_id);
+	if (index >= 0) {
+		_release(index);
+	}
+}
+
+void TimerWheel::clear() {
+	for (uint32_t i = 0; i < timers.size(); i++) {
+		if (timers[i].slot != INVALID) {
+			_release(i);
+		}
+	}
+}
+
+void TimerWheel::advance(uint64_t p_now_usec) {
+	const uint64_t now = p_now_usec / resolution_usec;
+	if (!started) {
+		current_tick = now;
+		target_tick = now;
+		started = true;
+		return;
+	}
+
+	if (now <= current_tick) {
+		return;
+	}
+
+	target_tick = now;
+	while (current_tick < target_tick) {
+		if (active_count == 0) {
+			current_tick = target_tick; // nothing scheduled, jump
+			break;
+		}
+
+		// the ticks in between have nothing to expire or to cascade
+		current_tick = _next_tick();
+
+		// refill the lower levels, top down, when their index wraps
+		for (uint32_t level = LEVELS - 1; level > 0; level--) {
+			if ((current_tick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) == 0) {
+				_cascade(level);
+			}
+		}
+
+		_expire();
+	}
+}
+
+TimerWheel::TimerWheel() {
+	for (uint32_t i = 0; i < LEVELS * SLOTS; i++) {
+		slots[i] = INVALID;
+	}
+	for (uint32_t i = 0; i < LEVELS; i++) {
+		occupied[i] = 0;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "core/templates/local_vector.h"
+#include "core/variant/callable.h"
+
+/**
+ * Hierarchical timer wheel.
+ *
+ * Timers are bucketed by expiry, so advance() only touches the ones that are
+ * due. Repeating timers reschedule themselves, they stay aligned to their
+ * interval and fire at most once per advance() even if several intervals were
+ * missed.
+ *
+ * Time is in microseconds, quantized to the wheel resolution (1 ms by default).
+ * advance() is idempotent for a given time, several owners can call it per frame.
+ * It jumps over the ticks where no slot expires or cascades, catching up after
+ * a stall costs the occupied slots, not the elapsed time.
+ */
+class TimerWheel {
+public:
+	typedef uint64_t TimerID; // 0 is never a valid id
+
+private:
+	static constexpr uint32_t SLOT_BITS = 6;
+	static constexpr uint32_t SLOTS = 1 << SLOT_BITS;
+	static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+	static constexpr uint32_t LEVELS = 4; // 2^24 ticks, about 4.6 hours at 1 ms
+	static constexpr uint32_t INVALID = UINT32_MAX;
+
+	struct Timer {
+		Callable callback;
+		uint64_t expires = 0; // in ticks
+		uint64_t interval = 0; // in ticks, 0 for one shot timers
+		uint32_t generation = 1;
+		uint32_t next = INVALID;
+		uint32_t prev = INVALID;
+		uint32_t slot = INVALID;
+	};
+
+	LocalVector<Timer> timers;
+	LocalVector<uint32_t> free_list;
+	uint32_t slots[LEVELS * SLOTS];
+	uint64_t occupied[LEVELS]; // a bit per non empty slot
+
+	uint64_t resolution_usec = 1000;
+	uint64_t current_tick = 0;
+	uint64_t target_tick = 0;
+	uint32_t active_count = 0;
+	bool started = false;
+
+	void _link(uint32_t p_index);
+	void _unlink(uint32_t p_index);
+	void _release(uint32_t p_index);
+	void _cascade(uint32_t p_level);
+	void _expire();
+	uint64_t _next_tick() const;
+	int64_t _resolve(TimerID p_id) const;
+
+public:
+	void set_resolution(uint64_t p_usec);
+	uint64_t get_resolution() const { return resolution_usec; }
+
+	TimerID add(uint64_t p_now_usec, double p_wait_time, const Callable &p_callback, bool p_repeat = true);
+	void remove(TimerID p_id);
+	bool has(TimerID p_id) const { return _resolve(p_id) >= 0; }
+	void clear();
+
+	uint32_t get_active_count() const { return active_count; }
+
+	void advance(uint64_t p_now_usec);
+
+	TimerWheel();
+};
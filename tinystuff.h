@@ -2,75 +2,27 @@
 
 #include "core/os/os.h"
 #include "core/templates/local_vector.h"
+#include "core/templates/sort_array.h"
 
 /**
- * A simple rescheduling timer in microseconds.
+ * Monotonic time sampled once per frame.
  *
- * A rescheduling timer automatically adjusts its next trigger time based on
- * it's wait time, ensuring consistent intervals even if checks
- * are delayed.
+ * Every subsystem reading it during a tick agrees on the same "now", and no
+ * extra clock call is made. Read OS::get_ticks_usec() directly only where a
+ * precise value matters, such as packet timestamps.
  */
-struct MicroTimer {
-	double wait_time = 1.0; // The wait time, in seconds.
-	uint64_t ticks = 0; // The last elapsed time in microseconds.
+struct FrameTime {
+	inline static uint64_t ticks_usec = 0;
 
-	/**
-	 * Starts or restarts the timer.
-	 */
-	void start() {
-		ticks = OS::get_singleton()->get_ticks_usec();
+	// Called at the start of each physics step and each multiplayer poll.
+	static uint64_t sample() {
+		ticks_usec = OS::get_singleton()->get_ticks_usec();
+		return ticks_usec;
 	}
 
-	/**
-	 * Checks if the timer have elapsed, and advances it if so.
-	 */
-	bool elapsed() {
-		constexpr uint64_t USEC_PER_SEC = 1000000ULL;
-		const uint64_t now = OS::get_singleton()->get_ticks_usec();
-		const uint64_t interval = (uint64_t)(wait_time * USEC_PER_SEC);
-		if (now - ticks >= interval) {
-			ticks += ((now - ticks) / interval) * interval;
-			return true;
-		}
-		return false;
-	}
-
-	MicroTimer() {}
-	MicroTimer(double p_wait_time) { wait_time = p_wait_time; }
-};
-
-/**
- * Wall clock aligned timer.
- */
-class MsecTimer {
-private:
-	uint64_t timeout = 0;
-	uint64_t time = 0;
-
-public:
-	void start() {
-		time = OS::get_singleton()->get_ticks_msec();
-	}
-
-	void set_timeout(double p_timeout) {
-		timeout = uint64_t((p_timeout > 0) ? p_timeout * 1000.0 : 0.0);
-	}
-
-	double get_timeout() const {
-		return double(timeout) / 1000.0;
-	}
-
-	bool elapsed() {
-		const uint64_t now = OS::get_singleton()->get_ticks_msec();
-		if (now - time >= timeout) {
-			time = now;
-			return true;
-		}
-		return false;
-	}
-
-	MsecTimer() {}
-	MsecTimer(double p_timeout) { set_timeout(p_timeout); }
+	_FORCE_INLINE_ static uint64_t get_ticks_usec() { return ticks_usec; }
+	_FORCE_INLINE_ static uint64_t get_ticks_msec() { return ticks_usec / 1000; }
+	_FORCE_INLINE_ static double get_time() { return ticks_usec / 1000000.0; }
 };
 
 /**
@@ -80,8 +32,15 @@ template <typename T>
 class FixedBuffer {
 private:
 	TightLocalVector<T> data;
+	mutable TightLocalVector<T> scratch; // order statistics work area
 	uint32_t head = 0;
 	uint32_t count = 0;
+	uint32_t mask = 0; // capacity - 1 in power of two mode
+	bool power_of_two = false;
+
+	_FORCE_INLINE_ uint32_t _wrap(uint32_t p_pos) const {
+		return power_of_two ? (p_pos & mask) : (p_pos % data.size());
+	}
 
 public:
 	_FORCE_INLINE_ uint32_t size() const { return count; }
@@ -97,27 +56,86 @@ public:
 		ERR_FAIL_INDEX_MSG(head, data.size(), "FixedBuffer capacity is zero, cannot append data.");
 		const uint32_t cap = capacity();
 		data[head] = value;
-		head = (head + 1) % cap;
+		head = _wrap(head + 1);
 		if (count < cap) {
 			count++;
 		}
 	}
 
-	void resize(uint32_t p_capacity) {
+	/**
+	 * Resizes and clears the buffer.
+	 *
+	 * In power of two mode the capacity is rounded up, so indexing becomes a mask.
+	 */
+	void resize(uint32_t p_capacity, bool p_power_of_two = false) {
+		power_of_two = p_power_of_two;
+		if (power_of_two && p_capacity > 0) {
+			p_capacity = next_power_of_2(p_capacity);
+		}
+		mask = p_capacity > 0 ? p_capacity - 1 : 0;
 		data.resize(p_capacity);
+		scratch.resize(p_capacity);
 		head = 0;
 		count = 0;
 	}
 
-	template <typename Comparator, bool Validate = SORT_ARRAY_VALIDATE_ENABLED, typename... Args>
-	Vector<T> sort_custom(Args &&...args) {
-		Vector<T> ret;
-		ret.resize(count);
-		memcpy(ret.ptrw(), data.ptr(), sizeof(T) * count);
-		ret.sort_custom<Comparator, Validate>(std::forward<Args>(args)...);
-		return ret;
+	// Element at p_index in insertion order, 0 being the oldest.
+	_FORCE_INLINE_ const T &operator[](uint32_t p_index) const {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, count);
+		return data[_wrap(head + data.size() - count + p_index)];
+	}
+
+	// Raw storage, the first size() elements are valid but not in insertion order.
+	_FORCE_INLINE_ const T *ptr() const { return data.ptr(); }
+
+	template <typename Comparator>
+	T min() const {
+		ERR_FAIL_COND_V_MSG(count == 0, T(), "FixedBuffer is empty.");
+		Comparator compare;
+		uint32_t best = 0;
+		for (uint32_t i = 1; i < count; i++) {
+			if (compare(data[i], data[best])) {
+				best = i;
+			}
+		}
+		return data[best];
+	}
+
+	template <typename Comparator>
+	T max() const {
+		ERR_FAIL_COND_V_MSG(count == 0, T(), "FixedBuffer is empty.");
+		Comparator compare;
+		uint32_t best = 0;
+		for (uint32_t i = 1; i < count; i++) {
+			if (compare(data[best], data[i])) {
+				best = i;
+			}
+		}
+		return data[best];
+	}
+
+	/**
+	 * Returns the element that would be at p_nth if the buffer was sorted.
+	 *
+	 * Selection runs in a scratch copy allocated by resize(), so queries never touch the heap.
+	 */
+	template <typename Comparator>
+	T nth_element(uint32_t p_nth) const {
+		ERR_FAIL_COND_V_MSG(count == 0, T(), "FixedBuffer is empty.");
+		ERR_FAIL_UNSIGNED_INDEX_V(p_nth, count, T());
+		for (uint32_t i = 0; i < count; i++) {
+			scratch[i] = data[i];
+		}
+		SortArray<T, Comparator> sorter;
+		sorter.nth_element(0, count, p_nth, scratch.ptr());
+		return scratch[p_nth];
+	}
+
+	template <typename Comparator>
+	T median() const {
+		return nth_element<Comparator>(count / 2);
 	}
 
 	FixedBuffer() {}
-	FixedBuffer(uint32_t p_capacity) { data.resize(p_capacity); }
+	FixedBuffer(uint32_t p_capacity, bool p_power_of_two = false) { resize(p_capacity, p_power_of_two); }
 };